@@ -5,6 +5,7 @@
 #include "PixelsScanFunction.hpp"
 #include "physical/StorageArrayScheduler.h"
 #include "profiler/CountProfiler.h"
+#include "duckdb/storage/buffer_manager.hpp"
 
 namespace duckdb {
 
@@ -19,30 +20,124 @@ static idx_t PixelsScanGetBatchIndex(ClientContext &context, const FunctionData
 
 static double PixelsProgress(ClientContext &context, const FunctionData *bind_data_p,
                               const GlobalTableFunctionState *global_state) {
-	auto &bind_data = (PixelsReadBindData &)*bind_data_p;
-	if (bind_data.files.empty()) {
+	auto &gstate = (PixelsReadGlobalState &)*global_state;
+	auto &scheduler = gstate.storageArrayScheduler;
+	if (scheduler->getTaskSum() == 0) {
 		return 100.0;
 	}
-	auto percentage = bind_data.curFileId * 100.0 / bind_data.files.size();
+	auto percentage = scheduler->getAcquiredTaskSum() * 100.0 / scheduler->getTaskSum();
 	return percentage;
 }
 
 static unique_ptr<NodeStatistics> PixelsCardinality(ClientContext &context, const FunctionData *bind_data) {
 	auto &data = (PixelsReadBindData &)*bind_data;
 
-	return make_uniq<NodeStatistics>(data.initialPixelsReader->getNumberOfRows() * data.files.size());
+	// the row counts of all files are read from their tails at bind time, so the cardinality is exact
+	return make_uniq<NodeStatistics>(data.numberOfRows, data.numberOfRows);
+}
+
+unique_ptr<BaseStatistics> PixelsScanFunction::PixelsScanStats(ClientContext &context, const FunctionData *bind_data_p,
+                                                               column_t column_index) {
+	auto &bind_data = (PixelsReadBindData &)*bind_data_p;
+	if (IsRowIdColumnId(column_index) || column_index >= bind_data.columnStats.size()) {
+		return nullptr;
+	}
+	auto &statistic = bind_data.columnStats.at(column_index);
+	auto columnType = bind_data.fileSchema->getChildren().at(column_index);
+	Value min;
+	Value max;
+	switch (columnType->getCategory()) {
+		case TypeDescription::SHORT:
+		case TypeDescription::INT:
+			if (statistic.has_intstatistics() && statistic.intstatistics().has_minimum() &&
+			    statistic.intstatistics().has_maximum()) {
+				min = Value::INTEGER((int32_t) statistic.intstatistics().minimum());
+				max = Value::INTEGER((int32_t) statistic.intstatistics().maximum());
+			}
+			break;
+		case TypeDescription::LONG:
+			if (statistic.has_intstatistics() && statistic.intstatistics().has_minimum() &&
+			    statistic.intstatistics().has_maximum()) {
+				min = Value::BIGINT(statistic.intstatistics().minimum());
+				max = Value::BIGINT(statistic.intstatistics().maximum());
+			}
+			break;
+		case TypeDescription::DECIMAL:
+			// long decimals are not stored as unscaled int64 values
+			if (columnType->getPrecision() <= 18 && statistic.has_intstatistics() &&
+			    statistic.intstatistics().has_minimum() && statistic.intstatistics().has_maximum()) {
+				min = Value::DECIMAL(statistic.intstatistics().minimum(), columnType->getPrecision(),
+				                     columnType->getScale());
+				max = Value::DECIMAL(statistic.intstatistics().maximum(), columnType->getPrecision(),
+				                     columnType->getScale());
+			}
+			break;
+		case TypeDescription::DATE:
+			if (statistic.has_datestatistics() && statistic.datestatistics().has_minimum() &&
+			    statistic.datestatistics().has_maximum()) {
+				min = Value::DATE(date_t(statistic.datestatistics().minimum()));
+				max = Value::DATE(date_t(statistic.datestatistics().maximum()));
+			}
+			break;
+		case TypeDescription::TIMESTAMP:
+			if (statistic.has_timestampstatistics() && statistic.timestampstatistics().has_minimum() &&
+			    statistic.timestampstatistics().has_maximum()) {
+				min = Value::TIMESTAMP(timestamp_t(statistic.timestampstatistics().minimum()));
+				max = Value::TIMESTAMP(timestamp_t(statistic.timestampstatistics().maximum()));
+			}
+			break;
+		case TypeDescription::VARCHAR:
+		case TypeDescription::CHAR:
+			if (statistic.has_stringstatistics() && statistic.stringstatistics().has_minimum() &&
+			    statistic.stringstatistics().has_maximum()) {
+				min = Value(statistic.stringstatistics().minimum());
+				max = Value(statistic.stringstatistics().maximum());
+			}
+			break;
+		default:
+			break;
+	}
+	vector<LogicalType> types;
+	TransformDuckdbType(bind_data.fileSchema, types);
+	auto &type = types.at(column_index);
+	unique_ptr<BaseStatistics> result;
+	if (min.IsNull()) {
+		result = BaseStatistics::CreateUnknown(type).ToUnique();
+	} else if (type.id() == LogicalTypeId::VARCHAR) {
+		auto stats = StringStats::CreateEmpty(type);
+		StringStats::Update(stats, string_t(StringValue::Get(min)));
+		StringStats::Update(stats, string_t(StringValue::Get(max)));
+		// only the bounds are known, not the strings between them
+		StringStats::ResetMaxStringLength(stats);
+		StringStats::SetContainsUnicode(stats);
+		stats.Set(StatsInfo::CAN_HAVE_VALID_VALUES);
+		result = stats.ToUnique();
+	} else {
+		auto stats = NumericStats::CreateEmpty(type);
+		NumericStats::SetMin(stats, min);
+		NumericStats::SetMax(stats, max);
+		stats.Set(StatsInfo::CAN_HAVE_VALID_VALUES);
+		result = stats.ToUnique();
+	}
+	if (statistic.has_hasnull() && !statistic.hasnull()) {
+		result->Set(StatsInfo::CANNOT_HAVE_NULL_VALUES);
+	} else {
+		result->Set(StatsInfo::CAN_HAVE_NULL_VALUES);
+	}
+	return result;
 }
 
 TableFunctionSet PixelsScanFunction::GetFunctionSet() {
     TableFunction table_function("pixels_scan", {LogicalType::VARCHAR}, PixelsScanImplementation, PixelsScanBind,
 	                             PixelsScanInitGlobal, PixelsScanInitLocal);
 	table_function.projection_pushdown = true;
-//	table_function.filter_pushdown = true;
-    //table_function.filter_prune = true;
+	table_function.filter_pushdown = true;
+	table_function.filter_prune = true;
     enable_filter_pushdown = table_function.filter_pushdown;
     MultiFileReader::AddParameters(table_function);
 	table_function.get_batch_index = PixelsScanGetBatchIndex;
 	table_function.cardinality = PixelsCardinality;
+	table_function.statistics = PixelsScanStats;
 	table_function.table_scan_progress = PixelsProgress;
 	// TODO: maybe we need other code here later. Refer parquet-extension.cpp
     return MultiFileReader::CreateFunctionSet(table_function);
@@ -59,9 +154,15 @@ void PixelsScanFunction::PixelsScanImplementation(ClientContext &context,
     auto &gstate = (PixelsReadGlobalState &)*data_p.global_state;
     auto &bind_data = (PixelsReadBindData &)*data_p.bind_data;
 
+    if (gstate.metadata_only) {
+        PixelsScanMetadata(bind_data, data, gstate, output);
+        return;
+    }
+
     do {
         if (data.currPixelsRecordReader == nullptr ||
-           (data.currPixelsRecordReader->isEndOfFile() && data.vectorizedRowBatch->isEndOfFile())) {
+           (data.currPixelsRecordReader->isEndOfFile() &&
+            (data.vectorizedRowBatch == nullptr || data.vectorizedRowBatch->isEndOfFile()))) {
             if(data.currPixelsRecordReader != nullptr) {
                 data.currPixelsRecordReader.reset();
             }
@@ -70,41 +171,53 @@ void PixelsScanFunction::PixelsScanImplementation(ClientContext &context,
             }
         }
         auto currPixelsRecordReader = std::static_pointer_cast<PixelsRecordReaderImpl>(data.currPixelsRecordReader);
-        auto nextPixelsRecordReader = std::static_pointer_cast<PixelsRecordReaderImpl>(data.nextPixelsRecordReader);
 
         if (data.vectorizedRowBatch != nullptr && data.vectorizedRowBatch->isEndOfFile()) {
             data.vectorizedRowBatch = nullptr;
         }
         if (data.vectorizedRowBatch == nullptr) {
             data.vectorizedRowBatch = currPixelsRecordReader->readBatch(false);
+            // the remaining row groups and pixels of this file are pruned by the statistics
+            if (data.vectorizedRowBatch->isEndOfFile()) {
+                continue;
+            }
         }
         uint64_t currentLoc = data.vectorizedRowBatch->position();
         std::shared_ptr<TypeDescription> resultSchema = data.currPixelsRecordReader->getResultSchema();
         uint64_t remaining = data.vectorizedRowBatch->remaining();
         assert(remaining > 0);
         auto thisOutputChunkRows = MinValue<idx_t>(STANDARD_VECTOR_SIZE, remaining);
-        output.SetCardinality(thisOutputChunkRows);
         std::shared_ptr<PixelsBitMask> filterMask =
                 std::static_pointer_cast<PixelsRecordReaderImpl>(data.currPixelsRecordReader)->getFilterMask();
+        bool filtered = enable_filter_pushdown && filterMask != nullptr &&
+                        !filterMask->isAll(currentLoc, thisOutputChunkRows);
+        if (filtered && filterMask->count(currentLoc, thisOutputChunkRows) == 0) {
+            // no row of this chunk passes the filter
+            data.vectorizedRowBatch->increment(thisOutputChunkRows);
+            continue;
+        }
 
-        TransformDuckdbChunk(data, output, resultSchema, thisOutputChunkRows);
+        // the columns only used by the filters are scanned into all_columns and pruned from the output
+        DataChunk &scanned = gstate.CanRemoveFilterColumns() ? data.all_columns : output;
+        scanned.SetCardinality(thisOutputChunkRows);
+        TransformDuckdbChunk(data, scanned, resultSchema, thisOutputChunkRows);
 
-        // apply the filter operation
-        if (enable_filter_pushdown) {
-            idx_t sel_size = 0;
-            SelectionVector sel;
-            sel.Initialize(thisOutputChunkRows);
-            for (idx_t i = 0; i < thisOutputChunkRows; i++) {
-                if (filterMask->get(i + currentLoc)) {
-                    sel.set_index(sel_size++, i);
-                }
-            }
-            output.Slice(sel, sel_size);
+        // apply the filter operation, a chunk that fully passes the filter is not sliced
+        if (filtered) {
+            SelectionVector sel(thisOutputChunkRows);
+            idx_t sel_size = filterMask->toSelection(currentLoc, thisOutputChunkRows, sel.data());
+            scanned.Slice(sel, sel_size);
+        }
+        if (gstate.CanRemoveFilterColumns()) {
+            output.ReferenceColumns(data.all_columns, gstate.projection_ids);
         }
         if (output.size() > 0) {
             return;
         } else {
             output.Reset();
+            if (gstate.CanRemoveFilterColumns()) {
+                data.all_columns.Reset();
+            }
         }
     } while (true);
 }
@@ -124,6 +237,74 @@ struct compare_file_name {
     }
 };
 
+void PixelsScanFunction::MergeColumnStatistic(pixels::proto::ColumnStatistic &merged,
+                                              const pixels::proto::ColumnStatistic &statistic) {
+	// a bound is kept only if every file has it
+	if (merged.has_intstatistics()) {
+		auto &other = statistic.intstatistics();
+		auto *target = merged.mutable_intstatistics();
+		if (!statistic.has_intstatistics() || !other.has_minimum() || !other.has_maximum() ||
+		    !target->has_minimum() || !target->has_maximum()) {
+			merged.clear_intstatistics();
+		} else {
+			target->set_minimum(MinValue<int64_t>(target->minimum(), other.minimum()));
+			target->set_maximum(MaxValue<int64_t>(target->maximum(), other.maximum()));
+		}
+	}
+	if (merged.has_datestatistics()) {
+		auto &other = statistic.datestatistics();
+		auto *target = merged.mutable_datestatistics();
+		if (!statistic.has_datestatistics() || !other.has_minimum() || !other.has_maximum() ||
+		    !target->has_minimum() || !target->has_maximum()) {
+			merged.clear_datestatistics();
+		} else {
+			target->set_minimum(MinValue<int32_t>(target->minimum(), other.minimum()));
+			target->set_maximum(MaxValue<int32_t>(target->maximum(), other.maximum()));
+		}
+	}
+	if (merged.has_timestampstatistics()) {
+		auto &other = statistic.timestampstatistics();
+		auto *target = merged.mutable_timestampstatistics();
+		if (!statistic.has_timestampstatistics() || !other.has_minimum() || !other.has_maximum() ||
+		    !target->has_minimum() || !target->has_maximum()) {
+			merged.clear_timestampstatistics();
+		} else {
+			target->set_minimum(MinValue<int64_t>(target->minimum(), other.minimum()));
+			target->set_maximum(MaxValue<int64_t>(target->maximum(), other.maximum()));
+		}
+	}
+	if (merged.has_stringstatistics()) {
+		auto &other = statistic.stringstatistics();
+		auto *target = merged.mutable_stringstatistics();
+		if (!statistic.has_stringstatistics() || !other.has_minimum() || !other.has_maximum() ||
+		    !target->has_minimum() || !target->has_maximum()) {
+			merged.clear_stringstatistics();
+		} else {
+			if (other.minimum() < target->minimum()) {
+				target->set_minimum(other.minimum());
+			}
+			if (other.maximum() > target->maximum()) {
+				target->set_maximum(other.maximum());
+			}
+		}
+	}
+	if (merged.has_hasnull()) {
+		if (!statistic.has_hasnull()) {
+			merged.clear_hasnull();
+		} else {
+			merged.set_hasnull(merged.hasnull() || statistic.hasnull());
+		}
+	}
+}
+
+vector<int64_t> PixelsScanFunction::GetRowGroupRows(const std::shared_ptr<PixelsReader> &reader) {
+	vector<int64_t> rows;
+	for (int i = 0; i < reader->getRowGroupNum(); i++) {
+		rows.emplace_back(reader->getRowGroupInfo(i).numberofrows());
+	}
+	return rows;
+}
+
 unique_ptr<FunctionData> PixelsScanFunction::PixelsScanBind(
     						ClientContext &context, TableFunctionBindInput &input,
                             vector<LogicalType> &return_types, vector<string> &names) {
@@ -142,7 +323,7 @@ unique_ptr<FunctionData> PixelsScanFunction::PixelsScanBind(
     // sort the pxl file by file name, so that all SSD arrays can be fully utilized
     sort(files.begin(), files.end(), compare_file_name());
 
-	auto footerCache = std::make_shared<PixelsFooterCache>();
+	auto footerCache = PixelsFooterCache::Instance();
 	auto builder = std::make_shared<PixelsReaderBuilder>();
 
 	std::shared_ptr<::Storage> storage = StorageFactory::getInstance()->getStorage(::Storage::file);
@@ -159,6 +340,59 @@ unique_ptr<FunctionData> PixelsScanFunction::PixelsScanBind(
 	result->initialPixelsReader = pixelsReader;
 	result->fileSchema = fileSchema;
 	result->files = files;
+	// The row groups are needed to split the scan into row group ranges, and their row counts
+	// answer the scans without columns. The row counts and column statistics of all files are
+	// kept for the optimizer. Only the file tails are read, by concurrent threads.
+	vector<vector<int64_t>> rowGroupRows(files.size());
+	vector<ColumnStatisticList> fileColumnStats(files.size());
+	rowGroupRows.at(0) = GetRowGroupRows(pixelsReader);
+	fileColumnStats.at(0) = pixelsReader->getColumnStats();
+	idx_t num_threads = MinValue<idx_t>(TaskScheduler::GetScheduler(context).NumberOfThreads(), files.size() - 1);
+	std::atomic<idx_t> next_file(1);
+	vector<std::future<void>> tail_readers;
+	for (idx_t t = 0; t < num_threads; t++) {
+		tail_readers.emplace_back(std::async(std::launch::async, [&]() {
+			idx_t i;
+			while ((i = next_file++) < files.size()) {
+				auto reader = std::make_shared<PixelsReaderBuilder>()
+				                  ->setPath(files.at(i))
+				                  ->setStorage(storage)
+				                  ->setPixelsFooterCache(footerCache)
+				                  ->build();
+				rowGroupRows.at(i) = GetRowGroupRows(reader);
+				fileColumnStats.at(i) = reader->getColumnStats();
+				reader->close();
+			}
+		}));
+	}
+	for (auto &tail_reader : tail_readers) {
+		// rethrow the error of opening a file
+		tail_reader.get();
+	}
+	result->numberOfRows = 0;
+	for (auto &rows : rowGroupRows) {
+		result->rowGroupNums.emplace_back((int) rows.size());
+		result->rowGroupRows.insert(result->rowGroupRows.end(), rows.begin(), rows.end());
+		for (auto row : rows) {
+			result->numberOfRows += row;
+		}
+	}
+	result->columnStats.resize(fileSchema->getChildren().size());
+	for (idx_t col = 0; col < result->columnStats.size(); col++) {
+		auto &merged = result->columnStats.at(col);
+		for (idx_t i = 0; i < files.size(); i++) {
+			if (col >= (idx_t) fileColumnStats.at(i).size()) {
+				// a file without the statistic leaves nothing known about the column
+				merged.Clear();
+				break;
+			}
+			if (i == 0) {
+				merged = fileColumnStats.at(i).Get(col);
+			} else {
+				MergeColumnStatistic(merged, fileColumnStats.at(i).Get(col));
+			}
+		}
+	}
 
 	return std::move(result);
 }
@@ -172,20 +406,74 @@ unique_ptr<GlobalTableFunctionState> PixelsScanFunction::PixelsScanInitGlobal(
 
 	result->initialPixelsReader = bind_data.initialPixelsReader;
 
-    int max_threads = std::stoi(ConfigFactory::Instance().getProperty("pixel.threads"));
-    if (max_threads <= 0) {
-        max_threads = (int) bind_data.files.size();
+    // without an explicit budget, the buffers of the scans take at most half of the memory limit of DuckDB
+    if (std::stoull(ConfigFactory::Instance().getProperty("pixel.buffer.memory.limit")) == 0) {
+        ::BufferManager::Instance().setLimit(BufferManager::GetBufferManager(context).GetMaxMemory() / 2);
     }
 
-    result->storageArrayScheduler = std::make_shared<StorageArrayScheduler>(bind_data.files, max_threads);
+    int max_threads = std::stoi(ConfigFactory::Instance().getProperty("pixel.threads"));
+    // each storage device needs a running home thread, so don't exceed the threads of DuckDB
+    int duckdb_threads = TaskScheduler::GetScheduler(context).NumberOfThreads();
+    if (max_threads <= 0 || max_threads > duckdb_threads) {
+        max_threads = duckdb_threads;
+    }
 
-    result->file_index.resize(result->storageArrayScheduler->getDeviceSum());
+    // the files are split into tasks of row groups, so that a single large file can be scanned by all threads
+    auto files = bind_data.files;
+    auto rowGroupNums = bind_data.rowGroupNums;
+    result->storageArrayScheduler = std::make_shared<StorageArrayScheduler>(files, rowGroupNums, max_threads);
 
 	result->max_threads = max_threads;
 
+	result->query_id = (long) context.transaction.GetActiveQuery();
+
 	result->batch_index = 0;
 
     result->filters = input.filters.get();
+    // without any column or filter (e.g., count(*)), the rows are counted from the file tails
+    result->metadata_only = result->filters == nullptr || result->filters->filters.empty();
+    for (auto column_id : input.column_ids) {
+        if (!IsRowIdColumnId(column_id)) {
+            result->metadata_only = false;
+        }
+    }
+    // the filters are keyed by the index in column_ids, while the record reader indexes
+    // them by the read columns, which don't include the row id
+    if (result->filters != nullptr && !result->filters->filters.empty()) {
+        vector<idx_t> reader_indexes;
+        idx_t reader_index = 0;
+        bool has_row_id = false;
+        for (auto column_id : input.column_ids) {
+            reader_indexes.emplace_back(reader_index);
+            if (IsRowIdColumnId(column_id)) {
+                has_row_id = true;
+            } else {
+                reader_index++;
+            }
+        }
+        if (has_row_id) {
+            result->remapped_filters = make_uniq<TableFilterSet>();
+            for (auto &entry : result->filters->filters) {
+                if (IsRowIdColumnId(input.column_ids.at(entry.first))) {
+                    throw NotImplementedException("pixels_scan does not support filters on rowid");
+                }
+                result->remapped_filters->filters[reader_indexes.at(entry.first)] = entry.second->Copy();
+            }
+            result->filters = result->remapped_filters.get();
+        }
+    }
+    if (input.CanRemoveFilterColumns()) {
+        result->projection_ids = input.projection_ids;
+        vector<LogicalType> table_types;
+        TransformDuckdbType(bind_data.fileSchema, table_types);
+        for (auto column_id : input.column_ids) {
+            if (IsRowIdColumnId(column_id)) {
+                result->scanned_types.emplace_back(LogicalType::ROW_TYPE);
+            } else {
+                result->scanned_types.emplace_back(table_types.at(column_id));
+            }
+        }
+    }
 
 	return std::move(result);
 }
@@ -202,6 +490,9 @@ unique_ptr<LocalTableFunctionState> PixelsScanFunction::PixelsScanInitLocal(
     result->deviceID = gstate.storageArrayScheduler->acquireDeviceId();
 
 	result->column_ids = input.column_ids;
+	if (gstate.CanRemoveFilterColumns()) {
+		result->all_columns.Initialize(context.client, gstate.scanned_types);
+	}
 
 	auto fieldNames = bind_data.fileSchema->getFieldNames();
 
@@ -211,7 +502,18 @@ unique_ptr<LocalTableFunctionState> PixelsScanFunction::PixelsScanInitLocal(
 		}
 	}
 
-    ::DirectUringRandomAccessFile::Initialize();
+    if (gstate.metadata_only) {
+        return std::move(result);
+    }
+    if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "aio") {
+#ifdef ENABLE_LIBAIO
+        ::DirectAioRandomAccessFile::Initialize();
+#else
+        throw InvalidArgumentException("PhysicalLocalReader::readAsync: We don't support aio for our async read yet.");
+#endif
+    } else {
+        ::DirectUringRandomAccessFile::Initialize();
+    }
 	if(!PixelsParallelStateNext(context.client, bind_data, *result, gstate, true)) {
 		return nullptr;
 	}
@@ -294,6 +596,10 @@ void PixelsScanFunction::TransformDuckdbChunk(PixelsReadLocalState & data,
 			    auto intCol = std::static_pointer_cast<LongColumnVector>(col);
                 Vector vector(LogicalType::INTEGER,
                               (data_ptr_t)(intCol->current()), col->currentValid());
+                // the rows of a repeating block are all the same, so only the first one is read
+                if (col->isRepeating()) {
+                    vector.SetVectorType(VectorType::CONSTANT_VECTOR);
+                }
                 output.data.at(col_id).Reference(vector);
 //			    auto result_ptr = FlatVector::GetData<int>(output.data.at(col_id));
 //			    memcpy(result_ptr, intCol->intVector + row_offset, thisOutputChunkRows * sizeof(int));
@@ -307,6 +613,9 @@ void PixelsScanFunction::TransformDuckdbChunk(PixelsReadLocalState & data,
 				auto longCol = std::static_pointer_cast<LongColumnVector>(col);
                 Vector vector(LogicalType::BIGINT,
                               (data_ptr_t)(longCol->current()), col->currentValid());
+                if (col->isRepeating()) {
+                    vector.SetVectorType(VectorType::CONSTANT_VECTOR);
+                }
                 output.data.at(col_id).Reference(vector);
 //			    auto result_ptr = FlatVector::GetData<long>(output.data.at(col_id));
 //			    memcpy(result_ptr, longCol->longVector + row_offset, thisOutputChunkRows * sizeof(long));
@@ -338,6 +647,9 @@ void PixelsScanFunction::TransformDuckdbChunk(PixelsReadLocalState & data,
 			    auto dateCol = std::static_pointer_cast<DateColumnVector>(col);
                 Vector vector(LogicalType::DATE,
                               (data_ptr_t)(dateCol->current()), col->currentValid());
+                if (col->isRepeating()) {
+                    vector.SetVectorType(VectorType::CONSTANT_VECTOR);
+                }
                 output.data.at(col_id).Reference(vector);
 //			    auto result_ptr = FlatVector::GetData<int>(output.data.at(col_id));
 //			    memcpy(result_ptr, dateCol->dates + row_offset, thisOutputChunkRows * sizeof(int));
@@ -353,6 +665,9 @@ void PixelsScanFunction::TransformDuckdbChunk(PixelsReadLocalState & data,
                 auto tsCol = std::static_pointer_cast<TimestampColumnVector>(col);
                 Vector vector(LogicalType::TIMESTAMP,
                               (data_ptr_t)(tsCol->current()), col->currentValid());
+                if (col->isRepeating()) {
+                    vector.SetVectorType(VectorType::CONSTANT_VECTOR);
+                }
                 output.data.at(col_id).Reference(vector);
                 break;
             }
@@ -365,6 +680,12 @@ void PixelsScanFunction::TransformDuckdbChunk(PixelsReadLocalState & data,
 			case TypeDescription::CHAR:
 		    {
 			    auto binaryCol = std::static_pointer_cast<BinaryColumnVector>(col);
+			    if (binaryCol->dictionaryEncoded) {
+				    // the dictionary ids select from the dictionary shared by the chunk
+				    SelectionVector sel(binaryCol->currentDictIds());
+				    output.data.at(col_id).Slice(*binaryCol->dictionary, sel, thisOutputChunkRows);
+				    break;
+			    }
                 Vector vector(LogicalType::VARCHAR,
                               (data_ptr_t)(binaryCol->current()), col->currentValid());
                 output.data.at(col_id).Reference(vector);
@@ -382,6 +703,27 @@ void PixelsScanFunction::TransformDuckdbChunk(PixelsReadLocalState & data,
     vectorizedRowBatch->increment(thisOutputChunkRows);
 }
 
+void PixelsScanFunction::PixelsScanMetadata(const PixelsReadBindData &bind_data, PixelsReadLocalState &data,
+                                            PixelsReadGlobalState &gstate, DataChunk &output) {
+	while (data.metadata_remaining_rows == 0) {
+		StorageScanTask task;
+		if (!gstate.storageArrayScheduler->acquireTask(data.deviceID, data.last_batch_index, task)) {
+			return;
+		}
+		data.last_batch_index = task.batchID;
+		data.curr_batch_index = task.batchID;
+		for (int i = 0; i < task.rgLen; i++) {
+			data.metadata_remaining_rows += bind_data.rowGroupRows.at(task.batchID + i);
+		}
+	}
+	auto rows = MinValue<idx_t>(STANDARD_VECTOR_SIZE, data.metadata_remaining_rows);
+	for (auto &vector : output.data) {
+		vector.Reference(Value::BIGINT(42));
+	}
+	output.SetCardinality(rows);
+	data.metadata_remaining_rows -= rows;
+}
+
 bool PixelsScanFunction::PixelsParallelStateNext(ClientContext &context, const PixelsReadBindData &bind_data,
                                                   PixelsReadLocalState &scan_data,
                                                   PixelsReadGlobalState &parallel_state,
@@ -392,71 +734,99 @@ bool PixelsScanFunction::PixelsParallelStateNext(ClientContext &context, const P
     }
 
     auto& StorageInstance = parallel_state.storageArrayScheduler;
+    // The current task is taken from the front of the prefetch ring, and the ring is refilled
+    // up to pixel.prefetch.depth tasks, whose reads overlap the scan of the current task.
     // In the following two cases, the state ends:
-    // 1. When PixelsScanInitLocal invokes this function, if all files are
+    // 1. When PixelsScanInitLocal invokes this function, if all tasks are
     // fetched by other threads, this means this thread doesn't need do anything, so just return false;
-    // 2. When PixelsScanImplementation invokes this function (scan_data.next_file_index > -1), if
-    // scan_data.next_file_index >= (int) StorageInstance.getFileSum(scan_data.deviceID), it means the current file is already
-    // done, so the function return false.
-    if ((is_init_state && parallel_state.file_index.at(scan_data.deviceID) >= StorageInstance->getFileSum(scan_data.deviceID)) ||
-            scan_data.next_file_index >= StorageInstance->getFileSum(scan_data.deviceID)) {
-		::BufferPool::Reset();
-		// if async io is enabled, we need to unregister uring buffer
+    // 2. When PixelsScanImplementation invokes this function, if the prefetch ring is empty,
+    // it means the last task of this thread is already done, so the function return false.
+    int prefetch_depth = std::stoi(ConfigFactory::Instance().getProperty("pixel.prefetch.depth"));
+    vector<StorageScanTask> tasks;
+    // set when the memory budget stops the prefetching, then the idle slots of the buffer pool are released
+    bool out_of_budget = false;
+    if (is_init_state || !scan_data.prefetch_slots.empty()) {
+        int remaining_slots = (int) scan_data.prefetch_slots.size() - (is_init_state ? 0 : 1);
+        for (int i = remaining_slots; i < prefetch_depth; i++) {
+            // the next task must be fetched to go on, but the further ones are only
+            // prefetched if the buffers of another slot fit into the memory budget
+            if (i > 0 && !::BufferManager::Instance().hasBudget(::BufferPool::GetSlotBytes())) {
+                out_of_budget = true;
+                break;
+            }
+            StorageScanTask task;
+            if (!StorageInstance->acquireTask(scan_data.deviceID, scan_data.last_batch_index, task)) {
+                break;
+            }
+            scan_data.last_batch_index = task.batchID;
+            tasks.emplace_back(task);
+        }
+    }
+    if (is_init_state ? tasks.empty() : scan_data.prefetch_slots.empty()) {
+		// if async io is enabled, the reads in flight must finish before the buffers are released.
+		// The ring (or aio context) of this thread is kept for the following scans.
 		if(ConfigFactory::Instance().boolCheckProperty("localfs.enable.async.io")) {
 			if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "iouring") {
 				::DirectUringRandomAccessFile::Reset();
 			} else if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "aio") {
+#ifdef ENABLE_LIBAIO
+				::DirectAioRandomAccessFile::Reset();
+#else
 				throw InvalidArgumentException("PhysicalLocalReader::readAsync: We don't support aio for our async read yet.");
+#endif
 			}
 		}
+		::BufferPool::Reset();
         parallel_lock.unlock();
         return false;
     }
-
-    scan_data.curr_file_index = scan_data.next_file_index;
-    scan_data.curr_batch_index = scan_data.next_batch_index;
-    scan_data.next_file_index = parallel_state.file_index.at(scan_data.deviceID);
-    scan_data.next_batch_index = StorageInstance->getBatchID(scan_data.deviceID, scan_data.next_file_index);
-    scan_data.curr_file_name = scan_data.next_file_name;
-    parallel_state.file_index.at(scan_data.deviceID)++;
     parallel_lock.unlock();
     // The below code uses global state but no race happens, so we don't need the lock anymore
-    
+
 
     if(scan_data.currReader != nullptr) {
         scan_data.currReader->close();
     }
 
-    ::BufferPool::Switch();
-    scan_data.currReader = scan_data.nextReader;
-    scan_data.currPixelsRecordReader = scan_data.nextPixelsRecordReader;
-    // asyncReadComplete is not invoked in the first run (is_init_state = true)
-    if (scan_data.currPixelsRecordReader != nullptr) {
-        auto currPixelsRecordReader = std::static_pointer_cast<PixelsRecordReaderImpl>(scan_data.currPixelsRecordReader);
-        currPixelsRecordReader->asyncReadComplete((int)scan_data.column_names.size());
+    // asyncReadComplete of the current task is invoked by its first readBatch,
+    // so that the scan waits as late as possible
+    if (!is_init_state) {
+        auto &slot = scan_data.prefetch_slots.front();
+        scan_data.currReader = slot.reader;
+        scan_data.currPixelsRecordReader = slot.recordReader;
+        scan_data.curr_batch_index = slot.batch_index;
+        scan_data.curr_file_name = slot.file_name;
+        scan_data.prefetch_slots.pop_front();
     }
-    if(scan_data.next_file_index < StorageInstance->getFileSum(scan_data.deviceID)) {
-        auto footerCache = std::make_shared<PixelsFooterCache>();
+    // each prefetched task reads into its own slot of the buffer pool. The slot reused here
+    // belongs to the task scanned before the current one, which is already done.
+    for (auto &task : tasks) {
+        ::BufferPool::Switch();
+        auto footerCache = PixelsFooterCache::Instance();
         auto builder = std::make_shared<PixelsReaderBuilder>();
         std::shared_ptr<::Storage> storage = StorageFactory::getInstance()->getStorage(::Storage::file);
-        scan_data.next_file_name = StorageInstance->getFileName(scan_data.deviceID, scan_data.next_file_index);
-        scan_data.nextReader = builder->setPath(scan_data.next_file_name)
+        PixelsPrefetchSlot slot;
+        slot.file_name = task.fileName;
+        slot.batch_index = task.batchID;
+        slot.reader = builder->setPath(slot.file_name)
                 ->setStorage(storage)
                 ->setPixelsFooterCache(footerCache)
                 ->build();
 
-        PixelsReaderOption option = GetPixelsReaderOption(scan_data, parallel_state);
-        scan_data.nextPixelsRecordReader = scan_data.nextReader->read(option);
-        auto nextPixelsRecordReader = std::static_pointer_cast<PixelsRecordReaderImpl>(scan_data.nextPixelsRecordReader);
-        nextPixelsRecordReader->read();
-    } else {
-        scan_data.nextReader = nullptr;
-        scan_data.nextPixelsRecordReader = nullptr;
+        PixelsReaderOption option = GetPixelsReaderOption(scan_data, parallel_state, task);
+        slot.recordReader = slot.reader->read(option);
+        auto recordReader = std::static_pointer_cast<PixelsRecordReaderImpl>(slot.recordReader);
+        recordReader->read();
+        scan_data.prefetch_slots.emplace_back(slot);
+    }
+    if (out_of_budget) {
+        ::BufferPool::ReleaseIdleSlots((int) scan_data.prefetch_slots.size() + (is_init_state ? 0 : 1));
     }
     return true;
 }
 
-PixelsReaderOption PixelsScanFunction::GetPixelsReaderOption(PixelsReadLocalState &local_state, PixelsReadGlobalState &global_state) {
+PixelsReaderOption PixelsScanFunction::GetPixelsReaderOption(PixelsReadLocalState &local_state, PixelsReadGlobalState &global_state,
+                                                             const StorageScanTask &task) {
     PixelsReaderOption option;
     option.setSkipCorruptRecords(true);
     option.setTolerantSchemaEvolution(true);
@@ -465,10 +835,13 @@ PixelsReaderOption PixelsScanFunction::GetPixelsReaderOption(PixelsReadLocalStat
     option.setEnabledFilterPushDown(enable_filter_pushdown);
     // includeCols comes from the caller of PixelsPageSource
     option.setIncludeCols(local_state.column_names);
-    option.setRGRange(0, local_state.nextReader->getRowGroupNum());
-    option.setQueryId(1);
+    option.setRGRange(task.rgStart, task.rgLen);
+    option.setQueryId(global_state.query_id);
+    // the batches span pixels, so they are rounded up to whole DuckDB vectors and only
+    // the last batch of a row group produces a partial output chunk
     int stride = std::stoi(ConfigFactory::Instance().getProperty("pixel.stride"));
-    option.setBatchSize(stride);
+    int batchSize = (stride + STANDARD_VECTOR_SIZE - 1) / STANDARD_VECTOR_SIZE * STANDARD_VECTOR_SIZE;
+    option.setBatchSize(batchSize);
     return option;
 }
 }
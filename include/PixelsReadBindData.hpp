@@ -20,7 +20,14 @@ struct PixelsReadBindData : public TableFunctionData {
 	std::shared_ptr<PixelsReader> initialPixelsReader;
 	std::shared_ptr<TypeDescription> fileSchema;
 	vector<string> files;
-	atomic<idx_t> curFileId;
+	//! Number of row groups in each file
+	vector<int> rowGroupNums;
+	//! Number of rows in each row group of all files, indexed by the batch ID of the row group
+	vector<int64_t> rowGroupRows;
+	//! Number of rows in all files
+	idx_t numberOfRows;
+	//! The column statistics merged from the footers of all files
+	vector<pixels::proto::ColumnStatistic> columnStats;
 };
 
 }
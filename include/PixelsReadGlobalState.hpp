@@ -29,8 +29,9 @@ struct PixelsReadGlobalState : public GlobalTableFunctionState {
 
     std::shared_ptr<StorageArrayScheduler> storageArrayScheduler;
 
-	//! Index of file currently up for scanning
-	vector<idx_t> file_index;
+	//! The query of the scan, so that the read schedulers can tell the reads of different queries apart
+	long query_id;
+
 
 	//! Batch index of the next row group to be scanned
 	idx_t batch_index;
@@ -38,6 +39,18 @@ struct PixelsReadGlobalState : public GlobalTableFunctionState {
 	idx_t max_threads;
 
     TableFilterSet * filters;
+	//! The filters keyed by the record reader column indexes, if the row id shifts them from column_ids
+	unique_ptr<TableFilterSet> remapped_filters;
+	//! No column is read, so the rows are emitted from the row group row counts
+	bool metadata_only;
+	//! The indexes in column_ids of the output columns, empty if no filter-only column is pruned
+	vector<idx_t> projection_ids;
+	//! The types of all scanned columns, including the filter-only ones
+	vector<LogicalType> scanned_types;
+
+	bool CanRemoveFilterColumns() const {
+		return !projection_ids.empty();
+	}
 
 	idx_t MaxThreads() const override {
 		return max_threads;
@@ -12,38 +12,46 @@
 #include <duckdb/parser/parsed_data/create_scalar_function_info.hpp>
 #include "PixelsReader.h"
 #include "reader/PixelsRecordReader.h"
+#include <deque>
 
 namespace duckdb {
 
+//! A scan task whose chunk reads are issued ahead of its scan
+struct PixelsPrefetchSlot {
+	std::shared_ptr<PixelsReader> reader;
+	std::shared_ptr<PixelsRecordReader> recordReader;
+	std::string file_name;
+	idx_t batch_index;
+};
+
 struct PixelsReadLocalState : public LocalTableFunctionState {
     PixelsReadLocalState() {
-        curr_file_index = 0;
-        next_file_index = 0;
         curr_batch_index = 0;
-        next_batch_index = 0;
+        last_batch_index = -1;
+        metadata_remaining_rows = 0;
         rowOffset = 0;
         currPixelsRecordReader = nullptr;
-        nextPixelsRecordReader = nullptr;
         vectorizedRowBatch = nullptr;
         currReader = nullptr;
-        nextReader = nullptr;
     }
 	std::shared_ptr<PixelsRecordReader> currPixelsRecordReader;
-    std::shared_ptr<PixelsRecordReader> nextPixelsRecordReader;
 	// this is used for storing row batch results.
 	std::shared_ptr<VectorizedRowBatch> vectorizedRowBatch;
     int deviceID;
 	int rowOffset;
 	vector<column_t> column_ids;
+	//! The scanned columns, including the filter-only ones that are pruned from the output
+	DataChunk all_columns;
 	vector<string> column_names;
 	std::shared_ptr<PixelsReader> currReader;
-    std::shared_ptr<PixelsReader> nextReader;
-	idx_t curr_file_index;
-    idx_t next_file_index;
     idx_t curr_batch_index;
-    idx_t next_batch_index;
-    std::string next_file_name;
+    //! Batch index of the last acquired task, -1 if no task is acquired yet
+    int64_t last_batch_index;
+    //! The rows of the current task left to emit in the metadata-only scan
+    idx_t metadata_remaining_rows;
     std::string curr_file_name;
+    //! The tasks following the current one, whose reads are already issued
+    std::deque<PixelsPrefetchSlot> prefetch_slots;
 };
 
 }
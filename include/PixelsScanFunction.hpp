@@ -29,6 +29,7 @@
 #include "PixelsReaderBuilder.h"
 #include <iostream>
 #include <future>
+#include <atomic>
 #include <thread>
 #include "physical/scheduler/NoopScheduler.h"
 #include "physical/SchedulerFactory.h"
@@ -40,6 +41,7 @@
 #include "vector/ColumnVector.h"
 #include "vector/LongColumnVector.h"
 #include "physical/BufferPool.h"
+#include "physical/BufferManager.h"
 #include "profiler/TimeProfiler.h"
 #include "physical/natives/DirectUringRandomAccessFile.h"
 #ifndef DUCKDB_AMALGAMATION
@@ -62,8 +64,11 @@
 #include "duckdb/parser/tableref/table_function_ref.hpp"
 #include "duckdb/planner/operator/logical_get.hpp"
 #include "duckdb/storage/statistics/base_statistics.hpp"
+#include "duckdb/storage/statistics/numeric_stats.hpp"
+#include "duckdb/storage/statistics/string_stats.hpp"
 #include "duckdb/catalog/catalog_entry/table_function_catalog_entry.hpp"
 #include "duckdb/common/multi_file_reader.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
 #endif
 
 using namespace std;
@@ -84,7 +89,11 @@ public:
 	static bool PixelsParallelStateNext(ClientContext &context, const PixelsReadBindData &bind_data,
 	                                     PixelsReadLocalState &scan_data, PixelsReadGlobalState &parallel_state,
                                          bool is_init_state = false);
-    static PixelsReaderOption GetPixelsReaderOption(PixelsReadLocalState &local_state, PixelsReadGlobalState &global_state);
+	//! The min/max and null statistics of a column, merged from the footers of all files
+	static unique_ptr<BaseStatistics> PixelsScanStats(ClientContext &context, const FunctionData *bind_data_p,
+	                                                  column_t column_index);
+    static PixelsReaderOption GetPixelsReaderOption(PixelsReadLocalState &local_state, PixelsReadGlobalState &global_state,
+                                                    const StorageScanTask &task);
 private:
 	static void TransformDuckdbType(const std::shared_ptr<TypeDescription>& type,
 	                         vector<LogicalType> &return_types);
@@ -92,6 +101,13 @@ private:
 	                            DataChunk &output,
 	                            const std::shared_ptr<TypeDescription> & schema,
 	                            unsigned long thisOutputChunkRows);
+	//! Emit the rows of the next task from the row counts in the file tails, without reading any column
+	static void PixelsScanMetadata(const PixelsReadBindData &bind_data, PixelsReadLocalState &data,
+	                               PixelsReadGlobalState &gstate, DataChunk &output);
+	static vector<int64_t> GetRowGroupRows(const std::shared_ptr<PixelsReader> &reader);
+	//! Merge the file level statistic of a column into the statistic of all files
+	static void MergeColumnStatistic(pixels::proto::ColumnStatistic &merged,
+	                                 const pixels::proto::ColumnStatistic &statistic);
     static bool enable_filter_pushdown;
 };
 
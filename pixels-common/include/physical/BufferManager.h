@@ -0,0 +1,65 @@
+#ifndef PIXELS_BUFFERMANAGER_H
+#define PIXELS_BUFFERMANAGER_H
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "physical/natives/ByteBuffer.h"
+#include "physical/natives/DirectIoLib.h"
+
+/**
+ * BufferManager owns the aligned direct io memory of the buffer pools of all threads.
+ * The memory is handed out in slabs of size classes, four classes per power of two, so that
+ * a slab wastes at most a quarter of its size. Released slabs are kept for reuse.
+ * <p>
+ * The slabs in use and the cached slabs are bounded by a global byte budget
+ * (pixel.buffer.memory.limit). The cached slabs are freed when the budget is exceeded, and
+ * the optional allocations, such as the buffers of prefetched row groups, should check
+ * hasBudget first, so that prefetching backs off under memory pressure.
+ */
+class BufferManager {
+public:
+    /**
+     * @return the buffer manager shared by all threads of this process
+     */
+    static BufferManager & Instance();
+    /**
+     * Allocate a direct buffer of at least the given size. The buffer returns to the manager
+     * when the last reference to it is released. It always succeeds, even beyond the budget,
+     * since the row group being scanned can not wait.
+     */
+    std::shared_ptr<ByteBuffer> allocate(uint64_t bytes);
+    /**
+     * @return true if the given bytes can be allocated without exceeding the budget
+     */
+    bool hasBudget(uint64_t bytes);
+    /**
+     * Set the byte budget, 0 means no limit. The cached slabs beyond the budget are freed.
+     */
+    void setLimit(uint64_t bytes);
+    uint64_t getLimit();
+    // the bytes of the slabs in use
+    uint64_t getUsedBytes();
+    // the bytes of the released slabs kept for reuse
+    uint64_t getCachedBytes();
+private:
+    BufferManager();
+    static uint64_t getClassSize(int sizeClass);
+    static int getSizeClass(uint64_t bytes);
+    void release(const std::shared_ptr<ByteBuffer> &slab, int sizeClass);
+    /**
+     * Free the cached slabs, the largest first, until the given bytes fit into the budget.
+     * The lock must be held.
+     */
+    void trimCache(uint64_t bytes);
+    // the size of the smallest size class
+    static const uint64_t MIN_SLAB_SIZE;
+    std::mutex lock;
+    std::shared_ptr<DirectIoLib> directIoLib;
+    // the cached slabs of each size class
+    std::vector<std::vector<std::shared_ptr<ByteBuffer>>> freeSlabs;
+    uint64_t limit;
+    uint64_t usedBytes;
+    uint64_t cachedBytes;
+};
+#endif //PIXELS_BUFFERMANAGER_H
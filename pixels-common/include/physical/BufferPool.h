@@ -12,32 +12,89 @@
 #include "physical/natives/DirectIoLib.h"
 #include "exception/InvalidArgumentException.h"
 #include "utils/ColumnSizeCSVReader.h"
-#include <map>
-
-// when allocating buffer pool, we use the size of the first pxl file. Consider that
-// the remaining pxl file has larger size than the first file, we allocate some extra
-// size (10MB) to each column.
-// TODO: how to evaluate the maximal pool size
-#define EXTRA_POOL_SIZE 3*1024*1024
+#include <mutex>
 
 class DirectUringRandomAccessFile;
-// This class is global class. The variable is shared by each thread
+class DirectAioRandomAccessFile;
+// This class is global class. The variable is shared by each thread.
+// Each thread owns a ring of buffer slots: one slot holds the row group being decoded,
+// and the other slots hold the row groups prefetched ahead of it (pixel.prefetch.depth).
+// The buffers of a slot are allocated from the BufferManager when the slot is first read into,
+// so the memory of all threads is bounded by its budget.
 class BufferPool {
 public:
+	/**
+	 * Make sure the buffers of the current slot can hold the given chunks. The buffers are
+	 * allocated with the chunk sizes (or the sizes in pixel.column.size.path if larger) when
+	 * the slot is first used, and a buffer grows when a later chunk doesn't fit.
+	 * @param colIds the ids of the columns to read
+	 * @param bytes the chunk size of each column to read
+	 * @param columnNames the names of all the columns in the file
+	 */
 	static void Initialize(std::vector<uint32_t> colIds, std::vector<uint64_t> bytes, std::vector<std::string> columnNames);
 	static std::shared_ptr<ByteBuffer> GetBuffer(uint32_t colId);
+	static std::shared_ptr<ByteBuffer> GetBuffer(uint32_t colId, int slot);
     static int64_t GetBufferId(uint32_t index);
+    static int64_t GetBufferId(uint32_t index, int slot);
+    /**
+     * @return the slot that the following reads are issued into
+     */
+    static int GetBufferSlot();
+    /**
+     * @return the slot that owns the registered buffer of the given buffer id
+     */
+    static int GetBufferSlot(int64_t bufferId);
+    static int GetSlotNum();
+    /**
+     * Make sure the buffer of the given buffer id holds at least the given bytes, e.g., when a read
+     * merged from several chunks is issued into it. The buffer is replaced by a larger one if needed,
+     * so the caller must make sure that the slot of the buffer is not being read or decoded.
+     * @return the buffer of the buffer id
+     */
+    static std::shared_ptr<ByteBuffer> Reserve(int64_t bufferId, uint64_t bytes);
+    /**
+     * @return the ids of the columns in the pool, in the order of their buffer ids in a slot
+     */
+    static std::vector<uint32_t> GetColumnIds();
+    /**
+     * @return the bytes of the buffers of the current slot, which is the memory that
+     *         another prefetched row group takes
+     */
+    static uint64_t GetSlotBytes();
+    /**
+     * Release the buffers of the slots that are not in use to the BufferManager.
+     * @param slotsInUse the number of slots in use, which are the current slot and the ones before it
+     */
+    static void ReleaseIdleSlots(int slotsInUse);
+    /**
+     * Move to the next slot of the ring. The caller must make sure that the row group
+     * previously read into that slot is no longer in use.
+     */
     static void Switch();
 	static void Reset();
 private:
 	BufferPool() = default;
+	/**
+	 * @return the column sizes in pixel.column.size.path, or nullptr if it is not set.
+	 *         The file is only parsed once.
+	 */
+	static std::shared_ptr<ColumnSizeCSVReader> GetColumnSizes();
+	static std::shared_ptr<ByteBuffer> AllocateBuffer(uint64_t bytes);
 	static thread_local int colCount;
-	static thread_local std::map<uint32_t, uint64_t> nrBytes;
+	// the column id of each buffer in a slot
+	static thread_local std::vector<uint32_t> columnIds;
 	static thread_local bool isInitialized;
-	static thread_local std::map<uint32_t, std::shared_ptr<ByteBuffer>> buffers[2];
-	static std::shared_ptr<DirectIoLib> directIoLib;
+	// the buffers of each slot, indexed by column id. The buffers of the slots not used yet are nullptr
+	static thread_local std::vector<std::vector<std::shared_ptr<ByteBuffer>>> buffers;
+	// the bytes each buffer is allocated for, indexed like buffers. The buffer itself is larger,
+	// but its extra bytes are the slack an unaligned direct read needs, so they can't hold a larger chunk
+	static thread_local std::vector<std::vector<uint64_t>> bufferBytes;
+	// the initial buffer size of each column, indexed by column id, 0 if the column is not in the pool
+	static thread_local std::vector<uint64_t> columnBytes;
+	static std::mutex columnSizesMutex;
+	static std::shared_ptr<ColumnSizeCSVReader> columnSizes;
     static thread_local int currBufferIdx;
-    static thread_local int nextBufferIdx;
     friend class DirectUringRandomAccessFile;
+    friend class DirectAioRandomAccessFile;
 };
 #endif // DUCKDB_BUFFERPOOL_H
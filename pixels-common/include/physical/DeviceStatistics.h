@@ -0,0 +1,118 @@
+#ifndef PIXELS_DEVICESTATISTICS_H
+#define PIXELS_DEVICESTATISTICS_H
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * The measurements of a storage device and the merge parameters chosen from them.
+ */
+struct DeviceStatistic {
+    std::string device;
+    uint64_t requests;
+    uint64_t bytes;
+    // the estimated fixed cost of a request in seconds, and the transfer rate in bytes per second.
+    // They are 0 if there are not enough measurements yet
+    double latency;
+    double bandwidth;
+    int mergeGap;
+    int maxMergeSize;
+};
+
+/**
+ * DeviceStatistics measures the reads of each storage device (as identified by
+ * StorageArrayScheduler) online, and picks the merge parameters of the sort-merge schedulers.
+ * The time of a read is modeled as latency + bytes / bandwidth, and the model is fitted by a
+ * least squares regression over the recent reads. Skipping a gap costs gap / bandwidth, and
+ * issuing another request costs latency, so the merge gap is latency * bandwidth. The merged
+ * requests are bounded to a multiple of it, where the latency is a small part of the read time.
+ * Before the model is fitted, or if read.request.merge.adaptive is false, the configured
+ * read.request.merge.gap and read.request.merge.max.size are used.
+ * The synchronous reads are all measured, and the async reads are sampled by AsyncReadSampler.
+ */
+class DeviceStatistics {
+public:
+    static DeviceStatistics & Instance();
+    /**
+     * Record a read of the given file.
+     * @param path the path of the file
+     * @param bytes the bytes read
+     * @param seconds the time the read takes
+     */
+    void record(const std::string &path, uint64_t bytes, double seconds);
+    /**
+     * @return the maximal gap between two requests that are merged, for the device of the file
+     */
+    int getMergeGap(const std::string &path);
+    /**
+     * @return the maximal length of a merged request, for the device of the file
+     */
+    int getMaxMergeSize(const std::string &path);
+    std::vector<DeviceStatistic> getStatistics();
+    void Print();
+private:
+    DeviceStatistics();
+    // the running sums of the exponentially decayed regression of read time on read bytes
+    struct Device {
+        uint64_t requests = 0;
+        uint64_t bytes = 0;
+        double weight = 0;
+        double sumBytes = 0;
+        double sumSeconds = 0;
+        double sumBytes2 = 0;
+        double sumBytesSeconds = 0;
+        double latency = 0;
+        double bandwidth = 0;
+        int mergeGap;
+        int maxMergeSize;
+    };
+    Device & getDevice(const std::string &deviceName);
+    void fit(Device &device);
+    // the weight of the older reads is multiplied by DECAY for each new read
+    static const double DECAY;
+    // the number of reads before the model is fitted
+    static const int MIN_SAMPLES;
+    // the ratio of the maximal merged request to the merge gap
+    static const int MERGE_SIZE_FACTOR;
+    static const int MIN_MERGE_SIZE;
+    static const int MAX_MERGE_GAP;
+    std::mutex lock;
+    bool adaptive;
+    int configuredGap;
+    int configuredMaxSize;
+    std::unordered_map<std::string, Device> devices;
+};
+/**
+ * AsyncReadSampler times one async read at a time for DeviceStatistics. Only the first read
+ * issued into an idle queue is sampled, from its submission to its completion, so that its
+ * time is not spent waiting behind the reads already in flight.
+ */
+class AsyncReadSampler {
+public:
+    /**
+     * Called when a read is prepared. It is sampled if no read is sampled yet and the queue is idle.
+     * @param idle whether no read is pending or in flight in the queue
+     */
+    void prepare(const std::string &path, uint64_t tag, uint64_t bytes, bool idle);
+    /**
+     * Called right before the pending reads are submitted.
+     */
+    void submit();
+    /**
+     * Called when a read completes. The sampled read is recorded to DeviceStatistics.
+     */
+    void complete(uint64_t tag);
+    void reset();
+private:
+    bool sampling = false;
+    bool submitted = false;
+    uint64_t tag = 0;
+    uint64_t bytes = 0;
+    std::string path;
+    std::chrono::steady_clock::time_point start;
+};
+#endif //PIXELS_DEVICESTATISTICS_H
@@ -17,6 +17,11 @@
 class MergedRequest: public std::enable_shared_from_this<MergedRequest> {
 public:
     MergedRequest(Request first);
+    /**
+     * @param maxGap the maximal gap between two merged requests
+     * @param maxLength the maximal length of the merged request
+     */
+    MergedRequest(Request first, int maxGap, int maxLength);
     std::shared_ptr<MergedRequest> merge(Request curr);
     std::vector<std::shared_ptr<ByteBuffer>> complete(std::shared_ptr<ByteBuffer> buffer);
     long getStart();
@@ -30,6 +35,7 @@ private:
     int length; // the length of merged request
     int size;   // the number of sub-requests
     int maxGap;
+    int maxLength;
     std::vector<int> offsets; // the starting offset of the sub-requests in the response of the merged request
     std::vector<int> lengths; // the length of sub-requests
 };
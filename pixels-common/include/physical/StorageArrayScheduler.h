@@ -7,24 +7,82 @@
 
 #include "utils/ConfigFactory.h"
 #include <vector>
+#include <deque>
+#include <set>
 #include <mutex>
 #include <unordered_map>
 
+/**
+ * A scan task is a range of row groups in one file.
+ */
+struct StorageScanTask {
+    std::string fileName;
+    int rgStart;
+    int rgLen;
+    /**
+     * The ordinal of the first row group among the row groups of all files,
+     * in the order of the files given to the scheduler.
+     */
+    int64_t batchID;
+};
+
+/**
+ * StorageArrayScheduler assigns the scan tasks of the files on each storage device
+ * to the threads. DuckDB requires increasing batch IDs per thread, so a task skipped
+ * by a thread can only be taken by a thread whose last batch ID is smaller. The tasks
+ * are therefore handed out in batch ID order, unless another thread with a smaller last
+ * batch ID is still scanning. In that case, a thread takes the next task of its home
+ * device, or steals from the device with the most tasks left, and the skipped tasks are
+ * left to that thread. So no task is left behind, however many threads actually run.
+ */
 class StorageArrayScheduler {
 public:
-    StorageArrayScheduler(std::vector<std::string>& files, int threadNum);
+    /**
+     * @param files the files to scan, sorted in the output order
+     * @param rowGroupNums the number of row groups in each file
+     * @param threadNum the number of threads to scan the files
+     */
+    StorageArrayScheduler(std::vector<std::string>& files, std::vector<int>& rowGroupNums, int threadNum);
+    /**
+     * @return the name of the storage device of the file, which is the first
+     *         storage.directory.depth directories of its path
+     */
+    static std::string GetDeviceName(const std::string& file);
+    /**
+     * Register a thread to scan the files.
+     * @return the home device of the thread
+     */
     int acquireDeviceId();
     int getDeviceSum();
 
+    /**
+     * Get the next scan task for the thread whose home device is deviceID. The thread
+     * must be registered by acquireDeviceId. The batch ID of the returned task is always
+     * larger than lastBatchID, so that the batch IDs seen by a thread are increasing,
+     * even if it steals tasks. When the last thread is done, all the tasks are taken.
+     * @param deviceID the home device of the thread
+     * @param lastBatchID the batch ID of the last task of the thread, or -1 for the first task
+     * @param task the task to fill in
+     * @return false if there is no task left for this thread. The thread is then done
+     *         and must not acquire tasks anymore
+     */
+    bool acquireTask(int deviceID, int64_t lastBatchID, StorageScanTask& task);
+    uint64_t getTaskSum();
+    uint64_t getAcquiredTaskSum();
+
     std::string getFileName(int deviceID, int fileID);
     uint64_t getFileSum(int deviceID);
     int getMaxFileSum();
-    int getBatchID(int deviceID, int fileID);
 private:
     std::mutex m;
     int currentDeviceID;
     int devicesNum;
     std::vector<std::vector<std::string>> filesVector;
+    std::vector<std::deque<StorageScanTask>> tasksVector;
+    uint64_t taskSum;
+    uint64_t acquiredTaskSum;
+    // the last batch ID of each registered thread that is not done yet, -1 before its first task
+    std::multiset<int64_t> scanningLastBatchIDs;
 };
 
 #endif //DUCKDB_STORAGEARRAYSCHEDULER_H
@@ -9,6 +9,9 @@
 #include "physical/storage/LocalFS.h"
 #include "physical/natives/DirectRandomAccessFile.h"
 #include "physical/natives/DirectUringRandomAccessFile.h"
+#ifdef ENABLE_LIBAIO
+#include "physical/natives/DirectAioRandomAccessFile.h"
+#endif
 #include <iostream>
 #include <atomic>
 
@@ -19,9 +22,19 @@ public:
     std::shared_ptr<ByteBuffer> readFully(int length) override;
 	std::shared_ptr<ByteBuffer> readFully(int length, std::shared_ptr<ByteBuffer> bb) override;
 	std::shared_ptr<ByteBuffer> readAsync(int length, std::shared_ptr<ByteBuffer> bb, int index);
+	/**
+	 * Issue an async read merged from the chunks of several buffers into the buffer of the given index.
+	 * @param bufferIds the buffer ids of the chunks covered by the read, which all complete with it
+	 */
+	std::shared_ptr<ByteBuffer> readAsync(int length, std::shared_ptr<ByteBuffer> bb, int index,
+	                                      const std::vector<int64_t> &bufferIds);
 	void readAsyncSubmit(uint32_t size);
-	void readAsyncComplete(uint32_t size);
-	void readAsyncSubmitAndComplete(uint32_t size);
+	void readAsyncComplete(uint32_t size, int slot);
+	/**
+	 * @return true if the read issued into the given buffer is completed
+	 */
+	bool readAsyncComplete(int64_t bufferId, bool wait);
+	void readAsyncSubmitAndComplete(uint32_t size, int slot);
     void close() override;
     long getFileLength() override;
     void seek(long desired) override;
@@ -29,6 +42,7 @@ public:
     int readInt() override;
     char readChar() override;
     std::string getName() override;
+    std::string getPath() override;
 private:
     std::shared_ptr<LocalFS> local;
     std::string path;
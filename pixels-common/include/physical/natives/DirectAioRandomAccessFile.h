@@ -0,0 +1,96 @@
+#ifndef PIXELS_DIRECTAIORANDOMACCESSFILE_H
+#define PIXELS_DIRECTAIORANDOMACCESSFILE_H
+
+#include <libaio.h>
+#include "physical/natives/DirectRandomAccessFile.h"
+#include "exception/InvalidArgumentException.h"
+#include "physical/BufferPool.h"
+#include "physical/DeviceStatistics.h"
+#include <unordered_map>
+
+/**
+ * The async reads through Linux AIO, for the hosts that restrict io_uring. It has the same
+ * submit and complete contract as DirectUringRandomAccessFile: the reads are prepared by
+ * readAsync, submitted together by readAsyncSubmit, and waited for by buffer slot or by buffer.
+ * Each thread owns an aio context, which is kept across scans.
+ */
+class DirectAioRandomAccessFile: public DirectRandomAccessFile {
+public:
+	explicit DirectAioRandomAccessFile(const std::string& file);
+	/**
+	 * Create the aio context of this thread if it doesn't exist yet.
+	 */
+	static void Initialize();
+	/**
+	 * Finish the scan of this thread: wait for the reads in flight and clear the per-scan states.
+	 */
+	static void Reset();
+	std::shared_ptr<ByteBuffer> readAsync(int length, std::shared_ptr<ByteBuffer> buffer, int index);
+	/**
+	 * Issue a read merged from the chunks of several buffers into the given buffer.
+	 * Its completion counts as the completion of the reads of all the given buffer ids.
+	 * @param bufferIds the buffer ids of the chunks covered by the read
+	 */
+	std::shared_ptr<ByteBuffer> readAsync(int length, std::shared_ptr<ByteBuffer> buffer, int index,
+	                                      const std::vector<int64_t> &bufferIds);
+	/**
+	 * Submit all the reads prepared by readAsync. The reads are submitted again until the
+	 * kernel takes all of them, and completions are consumed when the context is full.
+	 * @param size the number of reads issued since the last submission
+	 */
+	void readAsyncSubmit(int size);
+	/**
+	 * Wait for the completion of the reads issued into the given buffer slot.
+	 * @param size the number of reads to wait for
+	 * @param slot the buffer slot of the reads
+	 */
+	void readAsyncComplete(int size, int slot);
+	/**
+	 * Check or wait for the completion of the read issued into the given buffer.
+	 * @param bufferId the buffer id the read is issued with
+	 * @param wait whether to wait for the read if it is not completed yet
+	 * @return true if the read is completed, and its completion is consumed
+	 */
+	bool readAsyncComplete(int64_t bufferId, bool wait);
+private:
+	/**
+	 * Consume all the available completions and count them for their buffers and buffer slots.
+	 * @param wait whether to wait for a completion if none is available
+	 */
+	static void reapCompletions(bool wait);
+	/**
+	 * Count the completion of a read for the buffers it reads into.
+	 */
+	static void countCompletion(uint64_t tag);
+	/**
+	 * Prepare a read into the given buffer, tagged with the given tag.
+	 */
+	std::shared_ptr<ByteBuffer> prepareRead(int length, std::shared_ptr<ByteBuffer> buffer, uint64_t tag);
+	// release the aio context of a thread when the thread exits
+	struct ContextReleaser {
+		~ContextReleaser();
+	};
+	static thread_local ContextReleaser contextReleaser;
+	// the maximal number of reads in flight of each thread
+	static const int QUEUE_DEPTH;
+	// the maximal number of completions consumed at a time
+	static const int EVENT_BATCH_SIZE;
+	// the tag of a merged read has this bit set, and the rest is its key in mergedReads
+	static const uint64_t MERGED_READ_TAG;
+	static thread_local io_context_t context;
+	static thread_local bool isInitialized;
+	// the reads prepared but not submitted yet
+	static thread_local std::vector<struct iocb> pendingIocbs;
+	// the reads submitted but not completed yet
+	static thread_local int inflightNum;
+	// the number of completed but not yet waited reads of each buffer slot
+	static thread_local std::vector<int> completedNum;
+	// the number of completed but not yet waited reads of each buffer id
+	static thread_local std::vector<int> completedBuffers;
+	// the buffer ids covered by each merged read in flight
+	static thread_local std::unordered_map<uint64_t, std::vector<int64_t>> mergedReads;
+	static thread_local uint64_t nextMergedRead;
+	// times a read of this thread now and then, so that the merge gap can be tuned for async scans
+	static thread_local AsyncReadSampler sampler;
+};
+#endif //PIXELS_DIRECTAIORANDOMACCESSFILE_H
@@ -11,21 +11,124 @@
 #include "exception/InvalidArgumentException.h"
 #include "DirectIoLib.h"
 #include "physical/BufferPool.h"
+#include "physical/DeviceStatistics.h"
+#include <unordered_map>
 class DirectUringRandomAccessFile: public DirectRandomAccessFile {
 public:
 	explicit DirectUringRandomAccessFile(const std::string& file);
 	static void RegisterBuffer(std::vector<std::shared_ptr<ByteBuffer>> buffers);
     static void RegisterBufferFromPool(std::vector<uint32_t> colIds);
+	/**
+	 * Create the ring of this thread if it doesn't exist yet. The ring is kept across scans
+	 * and is only released when the thread exits.
+	 */
 	static void Initialize();
+	/**
+	 * Finish the scan of this thread: wait for the reads in flight and clear the per-scan
+	 * states. The ring and the registered buffers are kept for the following scans.
+	 */
 	static void Reset();
 	std::shared_ptr<ByteBuffer> readAsync(int length, std::shared_ptr<ByteBuffer> buffer, int index);
+	/**
+	 * Issue a read merged from the chunks of several buffers into the buffer of the given index.
+	 * Its completion counts as the completion of the reads of all the given buffer ids.
+	 * @param bufferIds the buffer ids of the chunks covered by the read
+	 */
+	std::shared_ptr<ByteBuffer> readAsync(int length, std::shared_ptr<ByteBuffer> buffer, int index,
+	                                      const std::vector<int64_t> &bufferIds);
+	/**
+	 * Submit all the reads prepared by readAsync. The reads are submitted again until
+	 * the kernel takes all of them, and completions are consumed when the completion
+	 * queue is full.
+	 * @param size the number of reads issued since the last submission
+	 */
 	void readAsyncSubmit(int size);
-	void readAsyncComplete(int size);
+	/**
+	 * Wait for the completion of the reads issued into the given buffer slot.
+	 * The reads of different slots may complete in any order, so the completions
+	 * of other slots are counted and consumed when those slots are waited for.
+	 * @param size the number of reads to wait for
+	 * @param slot the buffer slot of the reads
+	 */
+	void readAsyncComplete(int size, int slot);
+	/**
+	 * Check or wait for the completion of the read issued into the given buffer, so that
+	 * a column chunk can be decoded as soon as it arrives, while the others are in flight.
+	 * @param bufferId the buffer id the read is issued with
+	 * @param wait whether to wait for the read if it is not completed yet
+	 * @return true if the read is completed, and its completion is consumed
+	 */
+	bool readAsyncComplete(int64_t bufferId, bool wait);
+	void close() override;
 	~DirectUringRandomAccessFile();
 private:
+	/**
+	 * @return the index of this file in the registered files of the ring of this thread,
+	 *         or -1 if the file cannot be registered
+	 */
+	int getFixedFileIndex();
+	/**
+	 * Get a submission queue entry, submitting the pending reads to make room if the queue is full.
+	 */
+	static struct io_uring_sqe * getSqe();
+	/**
+	 * Register the given buffers to the ring. Nothing is done if the same buffers are already
+	 * registered, and the registered buffers are updated in place if the table is large enough.
+	 * The buffers not allocated yet are nullptr.
+	 */
+	static void registerBuffers(const std::vector<std::shared_ptr<ByteBuffer>> &buffers);
+	/**
+	 * Prepare a read into the registered buffer of the given index, tagged with the given tag.
+	 */
+	std::shared_ptr<ByteBuffer> prepareRead(int length, std::shared_ptr<ByteBuffer> buffer, int index, uint64_t tag);
+	/**
+	 * Count the completion of a read for the buffers it reads into.
+	 */
+	static void countCompletion(uint64_t tag);
+	// release the ring of a thread when the thread exits
+	struct RingReleaser {
+		~RingReleaser();
+	};
+	static thread_local RingReleaser ringReleaser;
+	static void submitPending();
+	/**
+	 * Consume all the available completions and count them for their buffers and buffer slots.
+	 * @param wait whether to wait for a completion if none is available
+	 */
+	static void reapCompletions(bool wait);
+	// the maximal number of completions consumed at a time
+	static const int CQE_BATCH_SIZE;
+	// the tag of a merged read has this bit set, and the rest is its key in mergedReads
+	static const uint64_t MERGED_READ_TAG;
+	static const int QUEUE_DEPTH;
+	// the number of files that can be registered in the ring of each thread
+	static const int FIXED_FILE_NUM;
 	static thread_local struct io_uring * ring;
 	static thread_local bool isRegistered;
 	static thread_local struct iovec * iovecs;
 	static thread_local uint32_t iovecSize;
+	// the number of buffers the ring can hold without registering the buffers again,
+	// 0 if the ring doesn't support updating the registered buffers
+	static thread_local uint32_t iovecCapacity;
+	// the number of completed but not yet waited reads of each buffer slot
+	static thread_local std::vector<int> completedNum;
+	// the number of completed but not yet waited reads of each buffer id
+	static thread_local std::vector<int> completedBuffers;
+	// the buffer ids covered by each merged read in flight
+	static thread_local std::unordered_map<uint64_t, std::vector<int64_t>> mergedReads;
+	static thread_local uint64_t nextMergedRead;
+	// times a read of this thread now and then, so that the merge gap can be tuned for async scans
+	static thread_local AsyncReadSampler sampler;
+	// the reads prepared but not submitted yet, and the reads submitted but not completed yet
+	static thread_local int pendingNum;
+	static thread_local int inflightNum;
+	static thread_local bool sqpoll;
+	// the file descriptor registered at each index of the ring, or -1. It is empty if the
+	// files are not registered
+	static thread_local std::vector<int> fixedFiles;
+	static thread_local uint32_t nextFixedFile;
+	// the ring and the index this file is registered at
+	struct io_uring * fixedRing;
+	int fixedFileIndex;
 };
 #endif // DUCKDB_DIRECTURINGRANDOMACCESSFILE_H
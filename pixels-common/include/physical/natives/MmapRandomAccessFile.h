@@ -0,0 +1,56 @@
+#ifndef PIXELS_MMAPRANDOMACCESSFILE_H
+#define PIXELS_MMAPRANDOMACCESSFILE_H
+
+#include "physical/natives/PixelsRandomAccessFile.h"
+#include "physical/natives/ByteBuffer.h"
+#include <memory>
+#include <string>
+
+/**
+ * The memory mapping of a whole file, which is unmapped when the file and all the
+ * buffers read from it are released.
+ */
+struct FileMapping {
+    FileMapping(uint8_t * address, long length) : address(address), length(length) {}
+    ~FileMapping();
+    uint8_t * address;
+    long length;
+};
+
+/**
+ * A view into a file mapping. It keeps the mapping alive, and never frees the memory itself.
+ */
+class MmapByteBuffer: public ByteBuffer {
+public:
+    MmapByteBuffer(std::shared_ptr<FileMapping> mapping, long offset, uint32_t length);
+private:
+    std::shared_ptr<FileMapping> mapping;
+};
+
+/**
+ * MmapRandomAccessFile maps the whole file into memory, and the buffers it reads are views
+ * into the mapping. If the file is in the page cache, the column chunks are decoded straight
+ * from it without any copy. The chunks read are advised to the kernel (MADV_WILLNEED), so that
+ * the pages not cached yet are read ahead of decoding. The mapping is populated when it is
+ * created if localfs.mmap.populate is true.
+ */
+class MmapRandomAccessFile: public PixelsRandomAccessFile {
+public:
+    explicit MmapRandomAccessFile(const std::string& file);
+    void close() override;
+    std::shared_ptr<ByteBuffer> readFully(int len) override;
+    /**
+     * The given buffer is not used, since the result is a view into the mapping.
+     */
+    std::shared_ptr<ByteBuffer> readFully(int len, std::shared_ptr<ByteBuffer> bb) override;
+    long length() override;
+    void seek(long off) override;
+    long readLong() override;
+    char readChar() override;
+    int readInt() override;
+private:
+    std::shared_ptr<FileMapping> mapping;
+    long len;
+    long offset;
+};
+#endif //PIXELS_MMAPRANDOMACCESSFILE_H
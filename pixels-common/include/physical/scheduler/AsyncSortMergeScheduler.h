@@ -0,0 +1,37 @@
+#ifndef PIXELS_ASYNCSORTMERGESCHEDULER_H
+#define PIXELS_ASYNCSORTMERGESCHEDULER_H
+
+#include "physical/Scheduler.h"
+#include "physical/MergedRequest.h"
+#include <vector>
+
+/**
+ * AsyncSortMergeScheduler sorts the requests by their offsets and merges the neighbouring ones
+ * within the merge gap (up to the maximal merge size) of the device, like SortMergeScheduler.
+ * With async io, each merged request is a single read into the buffer of its first chunk, and the
+ * completed buffer is split into a view of each chunk. Without async io, e.g., for the row group
+ * footers, the merged requests are read synchronously. The results are in the order of the batch.
+ */
+class AsyncSortMergeScheduler : public Scheduler {
+public:
+    static Scheduler * Instance();
+    std::vector<std::shared_ptr<ByteBuffer>> executeBatch(std::shared_ptr<PhysicalReader> reader, RequestBatch batch, long queryId) override;
+    std::vector<std::shared_ptr<ByteBuffer>> executeBatch(std::shared_ptr<PhysicalReader> reader, RequestBatch batch,
+                                                          std::vector<std::shared_ptr<ByteBuffer>> reuseBuffers, long queryId) override;
+    ~AsyncSortMergeScheduler();
+private:
+    AsyncSortMergeScheduler();
+    /**
+     * Sort and merge the requests.
+     * @param requests the requests of the batch
+     * @param indexes the indexes in the batch of the requests merged into each merged request
+     * @param maxGap the maximal gap between two merged requests
+     * @param maxLength the maximal length of a merged request
+     * @return the merged requests in the order of their offsets
+     */
+    std::vector<std::shared_ptr<MergedRequest>> sortMerge(std::vector<Request> &requests,
+                                                          std::vector<std::vector<int>> &indexes,
+                                                          int maxGap, int maxLength);
+    static Scheduler * instance;
+};
+#endif //PIXELS_ASYNCSORTMERGESCHEDULER_H
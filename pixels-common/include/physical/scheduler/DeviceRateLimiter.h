@@ -0,0 +1,46 @@
+#ifndef PIXELS_DEVICERATELIMITER_H
+#define PIXELS_DEVICERATELIMITER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+/**
+ * The read budget of a storage device. The bandwidth and the IOPS are token buckets that hold
+ * at most one second of budget. The queries waiting for the device take the tokens in turn,
+ * so that a large scan can't starve the other queries on the same device.
+ */
+class DeviceRateLimiter {
+public:
+    /**
+     * @param bytesPerSecond the bandwidth budget, 0 means no limit
+     * @param opsPerSecond the IOPS budget, 0 means no limit
+     */
+    DeviceRateLimiter(double bytesPerSecond, double opsPerSecond);
+    /**
+     * Wait until it is the turn of the query and the buckets have the tokens of the reads,
+     * and take the tokens. The reads larger than a bucket wait for a full bucket and leave
+     * the bucket in debt.
+     * @param queryId the query that issues the reads
+     * @param bytes the bytes to read
+     * @param ops the number of reads
+     */
+    void acquire(long queryId, uint64_t bytes, uint64_t ops);
+private:
+    void refill();
+    std::mutex m;
+    std::condition_variable cv;
+    double bytesPerSecond;
+    double opsPerSecond;
+    double byteTokens;
+    double opTokens;
+    std::chrono::steady_clock::time_point lastRefill;
+    // the queries waiting for the device, in the order they take the tokens
+    std::deque<long> turns;
+    // the number of waiting reads of each query in turns
+    std::unordered_map<long, int> waiters;
+};
+#endif //PIXELS_DEVICERATELIMITER_H
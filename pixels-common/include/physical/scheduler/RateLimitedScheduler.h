@@ -0,0 +1,36 @@
+#ifndef PIXELS_RATELIMITEDSCHEDULER_H
+#define PIXELS_RATELIMITEDSCHEDULER_H
+
+#include "physical/Scheduler.h"
+#include "physical/scheduler/DeviceRateLimiter.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+/**
+ * RateLimitedScheduler bounds the reads of each storage device (as identified by
+ * StorageArrayScheduler) by read.request.rate.limit.mbps and read.request.rate.limit.iops.
+ * A batch waits for the tokens of all its requests, with the queries on a device taking
+ * turns, and is then executed by NoopScheduler.
+ */
+class RateLimitedScheduler : public Scheduler {
+public:
+    static Scheduler * Instance();
+    std::vector<std::shared_ptr<ByteBuffer>> executeBatch(std::shared_ptr<PhysicalReader> reader, RequestBatch batch, long queryId) override;
+    std::vector<std::shared_ptr<ByteBuffer>> executeBatch(std::shared_ptr<PhysicalReader> reader, RequestBatch batch,
+                                                          std::vector<std::shared_ptr<ByteBuffer>> reuseBuffers, long queryId) override;
+    ~RateLimitedScheduler();
+private:
+    RateLimitedScheduler();
+    /**
+     * @return the rate limiter of the device that stores the given file
+     */
+    std::shared_ptr<DeviceRateLimiter> getLimiter(const std::string &path);
+    static Scheduler * instance;
+    double bytesPerSecond;
+    double opsPerSecond;
+    std::mutex limitersMutex;
+    std::unordered_map<std::string, std::shared_ptr<DeviceRateLimiter>> limiters;
+};
+#endif //PIXELS_RATELIMITEDSCHEDULER_H
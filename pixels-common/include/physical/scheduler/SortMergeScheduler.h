@@ -15,6 +15,11 @@ class SortMergeScheduler : public Scheduler {
 public:
     static Scheduler * Instance();
 	std::vector<std::shared_ptr<MergedRequest>> sortMerge(RequestBatch batch, long queryId);
+	/**
+	 * @param maxGap the maximal gap between two merged requests
+	 * @param maxLength the maximal length of a merged request
+	 */
+	std::vector<std::shared_ptr<MergedRequest>> sortMerge(RequestBatch batch, long queryId, int maxGap, int maxLength);
 	std::vector<std::shared_ptr<ByteBuffer>> executeBatch(std::shared_ptr<PhysicalReader> reader,
 	                                                                          RequestBatch batch, long queryId) override;
 	std::vector<std::shared_ptr<ByteBuffer>> executeBatch(std::shared_ptr<PhysicalReader> reader, RequestBatch batch,
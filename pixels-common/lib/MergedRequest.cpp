@@ -14,7 +14,7 @@ std::shared_ptr<MergedRequest> MergedRequest::merge(Request curr) {
         throw InvalidArgumentException("MergedRequest: Can not merge requests from different queries (transactions).");
     }
     long gap = curr.start - this->end;
-    if(gap <= maxGap && this->length + gap + curr.length <= std::numeric_limits<int>::max()) {
+    if(gap <= maxGap && this->length + gap + curr.length <= maxLength) {
         this->offsets.emplace_back(this->length + (int) gap);
         this->lengths.emplace_back(curr.length);
         this->length += gap + curr.length;
@@ -22,14 +22,21 @@ std::shared_ptr<MergedRequest> MergedRequest::merge(Request curr) {
         this->size++;
         return shared_from_this();
     }
-    return std::make_shared<MergedRequest>(curr);
+    return std::make_shared<MergedRequest>(curr, maxGap, maxLength);
 }
 
-MergedRequest::MergedRequest(Request first) {
+MergedRequest::MergedRequest(Request first)
+    : MergedRequest(first, std::stoi(ConfigFactory::Instance().getProperty("read.request.merge.gap")),
+                    std::numeric_limits<int>::max()) {
+
+}
+
+MergedRequest::MergedRequest(Request first, int maxGap, int maxLength) {
     this->queryId = first.queryId;
     this->start = first.start;
     this->end = first.start + first.length;
-    this->maxGap = std::stoi(ConfigFactory::Instance().getProperty("read.request.merge.gap"));
+    this->maxGap = maxGap;
+    this->maxLength = maxLength;
     this->offsets.emplace_back(0);
     this->lengths.emplace_back(first.length);
     this->length = first.length;
@@ -0,0 +1,108 @@
+#include "physical/BufferManager.h"
+#include "utils/ConfigFactory.h"
+
+const uint64_t BufferManager::MIN_SLAB_SIZE = 64 * 1024;
+
+BufferManager::BufferManager() {
+    int fsBlockSize = std::stoi(ConfigFactory::Instance().getProperty("localfs.block.size"));
+    directIoLib = std::make_shared<DirectIoLib>(fsBlockSize);
+    limit = std::stoull(ConfigFactory::Instance().getProperty("pixel.buffer.memory.limit"));
+    usedBytes = 0;
+    cachedBytes = 0;
+}
+
+BufferManager & BufferManager::Instance() {
+    static BufferManager instance;
+    return instance;
+}
+
+uint64_t BufferManager::getClassSize(int sizeClass) {
+    return (MIN_SLAB_SIZE << (sizeClass / 4)) / 4 * (4 + sizeClass % 4);
+}
+
+int BufferManager::getSizeClass(uint64_t bytes) {
+    int sizeClass = 0;
+    while(getClassSize(sizeClass) < bytes) {
+        sizeClass++;
+    }
+    return sizeClass;
+}
+
+std::shared_ptr<ByteBuffer> BufferManager::allocate(uint64_t bytes) {
+    int sizeClass = getSizeClass(bytes);
+    uint64_t classSize = getClassSize(sizeClass);
+    std::shared_ptr<ByteBuffer> slab;
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        if(sizeClass < freeSlabs.size() && !freeSlabs.at(sizeClass).empty()) {
+            slab = freeSlabs.at(sizeClass).back();
+            freeSlabs.at(sizeClass).pop_back();
+            cachedBytes -= classSize;
+        } else {
+            trimCache(classSize);
+        }
+        usedBytes += classSize;
+    }
+    if(slab == nullptr) {
+        // the direct buffer has an extra block, since an unaligned direct read covers one more block
+        slab = directIoLib->allocateDirectBuffer((long) classSize);
+    }
+    // the user gets a view of the slab, and the slab goes back to the manager with the view
+    return std::shared_ptr<ByteBuffer>(new ByteBuffer(*slab, 0, slab->size()),
+                                       [slab, sizeClass](ByteBuffer * view) {
+                                           delete view;
+                                           BufferManager::Instance().release(slab, sizeClass);
+                                       });
+}
+
+void BufferManager::release(const std::shared_ptr<ByteBuffer> &slab, int sizeClass) {
+    uint64_t classSize = getClassSize(sizeClass);
+    std::lock_guard<std::mutex> guard(lock);
+    usedBytes -= classSize;
+    if(limit > 0 && usedBytes + cachedBytes + classSize > limit) {
+        // the slab is freed with its last reference
+        return;
+    }
+    if(freeSlabs.size() <= sizeClass) {
+        freeSlabs.resize(sizeClass + 1);
+    }
+    freeSlabs.at(sizeClass).emplace_back(slab);
+    cachedBytes += classSize;
+}
+
+bool BufferManager::hasBudget(uint64_t bytes) {
+    std::lock_guard<std::mutex> guard(lock);
+    // the cached slabs can be freed to make room
+    return limit == 0 || usedBytes + bytes <= limit;
+}
+
+void BufferManager::setLimit(uint64_t bytes) {
+    std::lock_guard<std::mutex> guard(lock);
+    limit = bytes;
+    trimCache(0);
+}
+
+void BufferManager::trimCache(uint64_t bytes) {
+    for(int sizeClass = (int) freeSlabs.size() - 1; sizeClass >= 0; sizeClass--) {
+        auto &slabs = freeSlabs.at(sizeClass);
+        while(limit > 0 && !slabs.empty() && usedBytes + cachedBytes + bytes > limit) {
+            slabs.pop_back();
+            cachedBytes -= getClassSize(sizeClass);
+        }
+    }
+}
+
+uint64_t BufferManager::getLimit() {
+    std::lock_guard<std::mutex> guard(lock);
+    return limit;
+}
+
+uint64_t BufferManager::getUsedBytes() {
+    std::lock_guard<std::mutex> guard(lock);
+    return usedBytes;
+}
+
+uint64_t BufferManager::getCachedBytes() {
+    std::lock_guard<std::mutex> guard(lock);
+    return cachedBytes;
+}
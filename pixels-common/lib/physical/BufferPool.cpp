@@ -3,86 +3,166 @@
 //
 
 #include "physical/BufferPool.h"
+#include "physical/BufferManager.h"
 
 thread_local int BufferPool::colCount = 0;
-thread_local std::map<uint32_t, uint64_t> BufferPool::nrBytes;
+thread_local std::vector<uint32_t> BufferPool::columnIds;
 thread_local bool BufferPool::isInitialized = false;
-thread_local std::map<uint32_t, std::shared_ptr<ByteBuffer>> BufferPool::buffers[2];
-// The currBufferIdx is set to 1. When executing the first file, this value is 0
-// since we call switch function first.
-thread_local int BufferPool::currBufferIdx = 1;
-thread_local int BufferPool::nextBufferIdx = 0;
-std::shared_ptr<DirectIoLib> BufferPool::directIoLib;
+thread_local std::vector<std::vector<std::shared_ptr<ByteBuffer>>> BufferPool::buffers;
+thread_local std::vector<std::vector<uint64_t>> BufferPool::bufferBytes;
+thread_local std::vector<uint64_t> BufferPool::columnBytes;
+// The currBufferIdx is set to 0 when the pool is initialized by the first read.
+thread_local int BufferPool::currBufferIdx = 0;
+std::mutex BufferPool::columnSizesMutex;
+std::shared_ptr<ColumnSizeCSVReader> BufferPool::columnSizes;
 
 void BufferPool::Initialize(std::vector<uint32_t> colIds, std::vector<uint64_t> bytes, std::vector<std::string> columnNames) {
 	assert(colIds.size() == bytes.size());
-	int fsBlockSize = std::stoi(ConfigFactory::Instance().getProperty("localfs.block.size"));
-    std::string columnSizePath = ConfigFactory::Instance().getProperty("pixel.column.size.path");
-    std::shared_ptr<ColumnSizeCSVReader> csvReader;
-    if (!columnSizePath.empty()) {
-        csvReader = std::make_shared<ColumnSizeCSVReader>(columnSizePath);
-    }
-
-    // give the maximal column size, which is stored in csv reader
 	if(!BufferPool::isInitialized) {
+        int prefetchDepth = std::stoi(ConfigFactory::Instance().getProperty("pixel.prefetch.depth"));
+        if (prefetchDepth < 1) {
+            throw InvalidArgumentException("BufferPool::Initialize: pixel.prefetch.depth must be positive. ");
+        }
+        auto csvReader = GetColumnSizes();
         currBufferIdx = 0;
-        nextBufferIdx = 1;
-		directIoLib = std::make_shared<DirectIoLib>(fsBlockSize);
+        columnBytes.assign(columnNames.size(), 0);
 		for(int i = 0; i < colIds.size(); i++) {
 			uint32_t colId = colIds.at(i);
-            std::string columnName = columnNames[colId];
-            for(int idx = 0; idx < 2; idx++) {
-                std::shared_ptr<ByteBuffer> buffer;
-                if (columnSizePath.empty()) {
-                    buffer = BufferPool::directIoLib->allocateDirectBuffer(bytes.at(i) + EXTRA_POOL_SIZE);
-                } else {
-                    buffer = BufferPool::directIoLib->allocateDirectBuffer(csvReader->get(columnName));
-                }
-
-                BufferPool::nrBytes[colId] = buffer->size();
-                BufferPool::buffers[idx][colId] = buffer;
+            // the column sizes from the csv file are only a hint, the buffers still grow if needed
+            uint64_t size = std::max(bytes.at(i), (uint64_t) 1);
+            if (csvReader != nullptr) {
+                size = std::max(size, (uint64_t) csvReader->get(columnNames[colId]));
             }
+            columnBytes.at(colId) = size;
 		}
+        buffers.clear();
+        buffers.resize(prefetchDepth + 1, std::vector<std::shared_ptr<ByteBuffer>>(columnNames.size()));
+        bufferBytes.assign(prefetchDepth + 1, std::vector<uint64_t>(columnNames.size(), 0));
 		BufferPool::colCount = colIds.size();
+		BufferPool::columnIds = colIds;
 		BufferPool::isInitialized = true;
-	} else {
-		// check if resize the buffer is needed
-		assert(colIds.size() == BufferPool::colCount);
-		for (int i = 0; i < colIds.size(); i++) {
-			uint32_t colId = colIds.at(i);
-			uint64_t byte = bytes.at(i);
-            std::string columnName = columnNames[colId];
-			if (BufferPool::nrBytes.find(colId) == BufferPool::nrBytes.end()) {
-				throw InvalidArgumentException("BufferPool::Initialize: no such the column id.");
-			}
-			// Note: this code should never happen in the pixels scenario
-			if (BufferPool::nrBytes[colId] < byte) {
-				throw InvalidArgumentException("the new buffer byte cannot larger than the previous buffer byte. ");
-			}
+	}
+	assert(colIds.size() == BufferPool::colCount);
+	// only the buffers of the current slot are allocated or grow, since the other slots
+	// may hold the row groups that are being read or decoded
+	auto &slotBuffers = BufferPool::buffers.at(currBufferIdx);
+	auto &slotBufferBytes = BufferPool::bufferBytes.at(currBufferIdx);
+	for (int i = 0; i < colIds.size(); i++) {
+		uint32_t colId = colIds.at(i);
+		uint64_t byte = bytes.at(i);
+		if (colId >= columnBytes.size() || columnBytes.at(colId) == 0) {
+			throw InvalidArgumentException("BufferPool::Initialize: no such the column id.");
+		}
+		if (slotBuffers.at(colId) == nullptr) {
+			slotBufferBytes.at(colId) = std::max(byte, columnBytes.at(colId));
+			slotBuffers.at(colId) = AllocateBuffer(slotBufferBytes.at(colId));
+			continue;
+		}
+		uint64_t oldSize = slotBufferBytes.at(colId);
+		if (oldSize < byte) {
+			slotBufferBytes.at(colId) = std::max(byte, oldSize + oldSize / 2);
+			slotBuffers.at(colId) = AllocateBuffer(slotBufferBytes.at(colId));
 		}
 	}
 }
 
+std::shared_ptr<ByteBuffer> BufferPool::AllocateBuffer(uint64_t bytes) {
+    return BufferManager::Instance().allocate(bytes);
+}
+
+std::shared_ptr<ColumnSizeCSVReader> BufferPool::GetColumnSizes() {
+    std::string columnSizePath = ConfigFactory::Instance().getProperty("pixel.column.size.path");
+    if (columnSizePath.empty()) {
+        return nullptr;
+    }
+    std::lock_guard<std::mutex> lock(columnSizesMutex);
+    if (columnSizes == nullptr) {
+        columnSizes = std::make_shared<ColumnSizeCSVReader>(columnSizePath);
+    }
+    return columnSizes;
+}
+
 int64_t BufferPool::GetBufferId(uint32_t index) {
-    return index + currBufferIdx * colCount;
+    return GetBufferId(index, currBufferIdx);
+}
+
+int64_t BufferPool::GetBufferId(uint32_t index, int slot) {
+    return index + slot * colCount;
+}
+
+int BufferPool::GetBufferSlot() {
+    return currBufferIdx;
+}
+
+int BufferPool::GetBufferSlot(int64_t bufferId) {
+    return (int) (bufferId / colCount);
+}
+
+int BufferPool::GetSlotNum() {
+    return (int) buffers.size();
 }
 
 std::shared_ptr<ByteBuffer> BufferPool::GetBuffer(uint32_t colId) {
-	return BufferPool::buffers[currBufferIdx][colId];
+	return GetBuffer(colId, currBufferIdx);
+}
+
+std::shared_ptr<ByteBuffer> BufferPool::GetBuffer(uint32_t colId, int slot) {
+	return BufferPool::buffers.at(slot).at(colId);
+}
+
+std::shared_ptr<ByteBuffer> BufferPool::Reserve(int64_t bufferId, uint64_t bytes) {
+	int slot = GetBufferSlot(bufferId);
+	uint32_t colId = columnIds.at(bufferId % colCount);
+	auto &buffer = BufferPool::buffers.at(slot).at(colId);
+	auto &bufferSize = BufferPool::bufferBytes.at(slot).at(colId);
+	if (buffer == nullptr) {
+		bufferSize = std::max(bytes, columnBytes.at(colId));
+		buffer = AllocateBuffer(bufferSize);
+	} else if (bufferSize < bytes) {
+		bufferSize = std::max(bytes, bufferSize + bufferSize / 2);
+		buffer = AllocateBuffer(bufferSize);
+	}
+	return buffer;
+}
+
+std::vector<uint32_t> BufferPool::GetColumnIds() {
+	return columnIds;
+}
+
+uint64_t BufferPool::GetSlotBytes() {
+    uint64_t slotBytes = 0;
+    if (!buffers.empty()) {
+        for (auto &buffer : buffers.at(currBufferIdx)) {
+            if (buffer != nullptr) {
+                slotBytes += buffer->size();
+            }
+        }
+    }
+    return slotBytes;
+}
+
+void BufferPool::ReleaseIdleSlots(int slotsInUse) {
+    int slotNum = (int) buffers.size();
+    for (int i = slotsInUse; i < slotNum; i++) {
+        auto &slotBuffers = buffers.at(((currBufferIdx - i) % slotNum + slotNum) % slotNum);
+        std::fill(slotBuffers.begin(), slotBuffers.end(), nullptr);
+    }
 }
 
 void BufferPool::Reset() {
 	BufferPool::isInitialized = false;
-	BufferPool::nrBytes.clear();
-    for(int idx = 0; idx < 2; idx++) {
-        BufferPool::buffers[idx].clear();
-    }
+	BufferPool::columnBytes.clear();
+    BufferPool::buffers.clear();
+    BufferPool::bufferBytes.clear();
 	BufferPool::colCount = 0;
+	BufferPool::columnIds.clear();
 }
 
 void BufferPool::Switch() {
-    currBufferIdx = 1 - currBufferIdx;
-    nextBufferIdx = 1 - nextBufferIdx;
+    // before the first read, the pool is not initialized yet and the first slot is used
+    if (!buffers.empty()) {
+        currBufferIdx = (currBufferIdx + 1) % (int) buffers.size();
+    }
 }
 
 
@@ -0,0 +1,147 @@
+#include "physical/DeviceStatistics.h"
+#include "physical/StorageArrayScheduler.h"
+#include "utils/ConfigFactory.h"
+#include <algorithm>
+#include <iostream>
+#include <limits>
+
+const double DeviceStatistics::DECAY = 0.99;
+const int DeviceStatistics::MIN_SAMPLES = 32;
+const int DeviceStatistics::MERGE_SIZE_FACTOR = 16;
+const int DeviceStatistics::MIN_MERGE_SIZE = 1024 * 1024;
+const int DeviceStatistics::MAX_MERGE_GAP = 64 * 1024 * 1024;
+
+DeviceStatistics::DeviceStatistics() {
+    // the reads of a mapped file only take views of the mapping, so they tell nothing about the device
+    adaptive = ConfigFactory::Instance().boolCheckProperty("read.request.merge.adaptive")
+               && !ConfigFactory::Instance().boolCheckProperty("localfs.enable.mmap");
+    configuredGap = std::stoi(ConfigFactory::Instance().getProperty("read.request.merge.gap"));
+    configuredMaxSize = std::stoi(ConfigFactory::Instance().getProperty("read.request.merge.max.size"));
+    if (configuredMaxSize <= 0) {
+        configuredMaxSize = std::numeric_limits<int>::max();
+    }
+}
+
+DeviceStatistics & DeviceStatistics::Instance() {
+    static DeviceStatistics instance;
+    return instance;
+}
+
+DeviceStatistics::Device & DeviceStatistics::getDevice(const std::string &deviceName) {
+    auto it = devices.find(deviceName);
+    if (it == devices.end()) {
+        Device device;
+        device.mergeGap = configuredGap;
+        device.maxMergeSize = configuredMaxSize;
+        it = devices.emplace(deviceName, device).first;
+    }
+    return it->second;
+}
+
+void DeviceStatistics::record(const std::string &path, uint64_t bytes, double seconds) {
+    if (!adaptive) {
+        return;
+    }
+    std::string deviceName = StorageArrayScheduler::GetDeviceName(path);
+    std::lock_guard<std::mutex> guard(lock);
+    auto &device = getDevice(deviceName);
+    device.requests++;
+    device.bytes += bytes;
+    device.weight = device.weight * DECAY + 1;
+    device.sumBytes = device.sumBytes * DECAY + (double) bytes;
+    device.sumSeconds = device.sumSeconds * DECAY + seconds;
+    device.sumBytes2 = device.sumBytes2 * DECAY + (double) bytes * (double) bytes;
+    device.sumBytesSeconds = device.sumBytesSeconds * DECAY + (double) bytes * seconds;
+    if (device.requests >= MIN_SAMPLES) {
+        fit(device);
+    }
+}
+
+void DeviceStatistics::fit(Device &device) {
+    double variance = device.weight * device.sumBytes2 - device.sumBytes * device.sumBytes;
+    // the bandwidth can't be told apart from the latency if the reads have similar sizes
+    if (variance <= 1e-6 * device.weight * device.sumBytes2) {
+        return;
+    }
+    double secondsPerByte = (device.weight * device.sumBytesSeconds - device.sumBytes * device.sumSeconds) / variance;
+    if (secondsPerByte <= 0) {
+        return;
+    }
+    device.bandwidth = 1 / secondsPerByte;
+    device.latency = std::max(0.0, (device.sumSeconds - secondsPerByte * device.sumBytes) / device.weight);
+    double gap = std::min(device.latency * device.bandwidth, (double) MAX_MERGE_GAP);
+    device.mergeGap = (int) gap;
+    // the configured max size bounds the memory of a merged request
+    device.maxMergeSize = (int) std::min(std::max(gap * MERGE_SIZE_FACTOR, (double) MIN_MERGE_SIZE),
+                                         (double) configuredMaxSize);
+}
+
+int DeviceStatistics::getMergeGap(const std::string &path) {
+    if (!adaptive) {
+        return configuredGap;
+    }
+    std::string deviceName = StorageArrayScheduler::GetDeviceName(path);
+    std::lock_guard<std::mutex> guard(lock);
+    return getDevice(deviceName).mergeGap;
+}
+
+int DeviceStatistics::getMaxMergeSize(const std::string &path) {
+    if (!adaptive) {
+        return configuredMaxSize;
+    }
+    std::string deviceName = StorageArrayScheduler::GetDeviceName(path);
+    std::lock_guard<std::mutex> guard(lock);
+    return getDevice(deviceName).maxMergeSize;
+}
+
+std::vector<DeviceStatistic> DeviceStatistics::getStatistics() {
+    std::lock_guard<std::mutex> guard(lock);
+    std::vector<DeviceStatistic> statistics;
+    for (auto &entry : devices) {
+        auto &device = entry.second;
+        statistics.emplace_back(DeviceStatistic{entry.first, device.requests, device.bytes, device.latency,
+                                                device.bandwidth, device.mergeGap, device.maxMergeSize});
+    }
+    return statistics;
+}
+
+void DeviceStatistics::Print() {
+    for (auto &statistic : getStatistics()) {
+        std::cout << "The device " << statistic.device << ": " << statistic.requests << " requests, "
+                  << statistic.bytes << " bytes, latency " << statistic.latency * 1000 << " ms, bandwidth "
+                  << statistic.bandwidth / 1024 / 1024 << " MB/s, merge gap " << statistic.mergeGap
+                  << ", max merge size " << statistic.maxMergeSize << std::endl;
+    }
+}
+
+void AsyncReadSampler::prepare(const std::string &path, uint64_t tag, uint64_t bytes, bool idle) {
+    if (sampling || !idle) {
+        return;
+    }
+    sampling = true;
+    submitted = false;
+    this->tag = tag;
+    this->bytes = bytes;
+    this->path = path;
+}
+
+void AsyncReadSampler::submit() {
+    if (sampling && !submitted) {
+        submitted = true;
+        start = std::chrono::steady_clock::now();
+    }
+}
+
+void AsyncReadSampler::complete(uint64_t tag) {
+    if (!sampling || !submitted || tag != this->tag) {
+        return;
+    }
+    sampling = false;
+    DeviceStatistics::Instance().record(path, bytes,
+                                        std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+}
+
+void AsyncReadSampler::reset() {
+    sampling = false;
+    submitted = false;
+}
@@ -26,6 +26,10 @@ SchedulerFactory::SchedulerFactory() {
         scheduler = NoopScheduler::Instance();
     } else if(name == "sortmerge") {
         scheduler =  SortMergeScheduler::Instance();
+    } else if(name == "asyncsortmerge") {
+        scheduler = AsyncSortMergeScheduler::Instance();
+    } else if(name == "ratelimited") {
+        scheduler = RateLimitedScheduler::Instance();
     } else {
         throw std::runtime_error("the read request scheduler is not support. ");
     }
@@ -2,53 +2,72 @@
 // Created by liyu on 1/21/24.
 //
 #include "physical/StorageArrayScheduler.h"
+#include <algorithm>
+#include <cassert>
 
 
-StorageArrayScheduler::StorageArrayScheduler(std::vector<std::string> &files, int threadNum) {
+StorageArrayScheduler::StorageArrayScheduler(std::vector<std::string> &files, std::vector<int> &rowGroupNums,
+                                             int threadNum) {
+    if (rowGroupNums.size() != files.size()) {
+        throw InvalidArgumentException("StorageArrayScheduler::initialize: "
+                                       "the row group numbers don't match the files. ");
+    }
     std::unordered_map<std::string, int> device2id;
-    int storageDepth = std::stoi(ConfigFactory::Instance().getProperty("storage.directory.depth"));
     filesVector.clear();
+    tasksVector.clear();
 
+    int fileId = 0;
+    int64_t batchID = 0;
     for (auto& file: files) {
-        std::string deviceName;
-        std::string tmp = file.substr(1);
-        for(int i = 0; i < storageDepth; i++) {
-            if (tmp.find('/') != std::string::npos) {
-                auto loc = tmp.find('/');
-                deviceName += tmp.substr(0,loc);
-                tmp = tmp.substr(loc);
-            } else {
-                throw InvalidArgumentException("StorageArrayScheduler::initialize: wrong storage depth. ");
-            }
-        }
-        // The following code makes sure that one thread can also process multiple devices
+        std::string deviceName = GetDeviceName(file);
+        // one thread can be the home thread of multiple devices. Fewer threads may actually
+        // run, so a device is not guaranteed to have a home thread, see acquireTask
         if (!device2id.count(deviceName)) {
             device2id[deviceName] = (int)device2id.size() % threadNum;
         }
         int id = device2id[deviceName];
         if (id >= filesVector.size()) {
             filesVector.emplace_back(std::vector<std::string>{});
+            tasksVector.emplace_back(std::deque<StorageScanTask>{});
         }
         filesVector[id].emplace_back(file);
+        // each row group is a task, and the tasks of a device are in the order of the files
+        for (int rgId = 0; rgId < rowGroupNums.at(fileId); rgId++) {
+            tasksVector[id].push_back(StorageScanTask{file, rgId, 1, batchID + rgId});
+        }
+        batchID += rowGroupNums.at(fileId);
+        fileId++;
     }
 
+    // The load imbalance between devices is handled by work stealing in acquireTask,
+    // so the thread count doesn't need to be divisible by the device number.
     devicesNum = (int)filesVector.size();
-    if (files.size() > threadNum && devicesNum % threadNum != 0 && threadNum % devicesNum != 0) {
-        throw InvalidArgumentException("StorageArrayScheduler::initialize: "
-                                       "if multiple devices are used, make sure "
-                                       "the thread count is divisible by device num or"
-                                       "the device num is divisible by the thread count. "
-                                       "Now the thread count is " + std::to_string(threadNum) +
-                                       " , and the storage device num is " + std::to_string(devicesNum) +
-                                       ". Otherwise the load balancing issue occurs. ");
-    }
+    taskSum = batchID;
+    acquiredTaskSum = 0;
     currentDeviceID = 0;
 }
 
+std::string StorageArrayScheduler::GetDeviceName(const std::string &file) {
+    int storageDepth = std::stoi(ConfigFactory::Instance().getProperty("storage.directory.depth"));
+    std::string deviceName;
+    std::string tmp = file.substr(1);
+    for(int i = 0; i < storageDepth; i++) {
+        if (tmp.find('/') != std::string::npos) {
+            auto loc = tmp.find('/');
+            deviceName += tmp.substr(0,loc);
+            tmp = tmp.substr(loc);
+        } else {
+            throw InvalidArgumentException("StorageArrayScheduler::initialize: wrong storage depth. ");
+        }
+    }
+    return deviceName;
+}
+
 int StorageArrayScheduler::acquireDeviceId() {
     m.lock();
     int deviceId = currentDeviceID;
     currentDeviceID = (currentDeviceID + 1) % devicesNum;
+    scanningLastBatchIDs.insert(-1);
     m.unlock();
     return deviceId;
 }
@@ -72,12 +91,80 @@ int StorageArrayScheduler::getMaxFileSum() {
     return result;
 }
 
-int StorageArrayScheduler::getBatchID(int deviceID, int fileID) {
-    int result = 0;
-    for(int i = 0; i < deviceID; i++) {
-        result += (int)filesVector[i].size();
+bool StorageArrayScheduler::acquireTask(int deviceID, int64_t lastBatchID, StorageScanTask &task) {
+    std::lock_guard<std::mutex> lock(m);
+    // the device of the task with the smallest batch ID left
+    int firstDeviceID = -1;
+    for (int i = 0; i < devicesNum; i++) {
+        auto &tasks = tasksVector.at(i);
+        if (!tasks.empty() && (firstDeviceID == -1 ||
+                               tasks.front().batchID < tasksVector.at(firstDeviceID).front().batchID)) {
+            firstDeviceID = i;
+        }
     }
-    result += fileID;
-    return result;
+    auto self = scanningLastBatchIDs.find(lastBatchID);
+    bool registered = self != scanningLastBatchIDs.end();
+    if (firstDeviceID == -1) {
+        if (registered) {
+            scanningLastBatchIDs.erase(self);
+        }
+        // the last thread is done, so every task must have been taken by some thread
+        assert(!scanningLastBatchIDs.empty() || acquiredTaskSum == taskSum);
+        return false;
+    }
+    int64_t firstBatchID = tasksVector.at(firstDeviceID).front().batchID;
+    // the tasks before the next one in batch ID order can be skipped only if another
+    // thread can still take them, i.e., its last batch ID is smaller than all of them
+    auto smaller = std::distance(scanningLastBatchIDs.begin(), scanningLastBatchIDs.lower_bound(firstBatchID));
+    bool canSkip = smaller > (registered && lastBatchID < firstBatchID ? 1 : 0);
+
+    int targetDeviceID = -1;
+    auto &homeTasks = tasksVector.at(deviceID);
+    if (!homeTasks.empty() && homeTasks.front().batchID > lastBatchID &&
+        (homeTasks.front().batchID == firstBatchID || canSkip)) {
+        targetDeviceID = deviceID;
+    } else if (canSkip) {
+        // steal from the device with the most tasks left after lastBatchID
+        for (int i = 0; i < devicesNum; i++) {
+            auto &tasks = tasksVector.at(i);
+            if (tasks.empty() || tasks.back().batchID <= lastBatchID) {
+                continue;
+            }
+            if (targetDeviceID == -1 || tasks.size() > tasksVector.at(targetDeviceID).size()) {
+                targetDeviceID = i;
+            }
+        }
+    } else {
+        // this thread has the smallest last batch ID, so it takes the next task in order
+        assert(firstBatchID > lastBatchID);
+        targetDeviceID = firstDeviceID;
+    }
+    if (targetDeviceID == -1) {
+        // the tasks left are all before lastBatchID, and are left to the threads behind this one
+        if (registered) {
+            scanningLastBatchIDs.erase(self);
+        }
+        return false;
+    }
+    auto &tasks = tasksVector.at(targetDeviceID);
+    auto it = std::upper_bound(tasks.begin(), tasks.end(), lastBatchID,
+                               [](int64_t batchID, const StorageScanTask &t) { return batchID < t.batchID; });
+    task = *it;
+    tasks.erase(it);
+    acquiredTaskSum++;
+    if (registered) {
+        scanningLastBatchIDs.erase(self);
+    }
+    scanningLastBatchIDs.insert(task.batchID);
+    return true;
+}
+
+uint64_t StorageArrayScheduler::getTaskSum() {
+    return taskSum;
+}
+
+uint64_t StorageArrayScheduler::getAcquiredTaskSum() {
+    std::lock_guard<std::mutex> lock(m);
+    return acquiredTaskSum;
 }
 
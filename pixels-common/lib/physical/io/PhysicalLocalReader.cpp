@@ -68,53 +68,114 @@ std::string PhysicalLocalReader::getName() {
     return path.substr(path.find_last_of('/') + 1);
 }
 
+std::string PhysicalLocalReader::getPath() {
+    return path;
+}
+
 std::shared_ptr<ByteBuffer> PhysicalLocalReader::readAsync(int length, std::shared_ptr<ByteBuffer> buffer, int index) {
 	numRequests++;
 	if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "iouring") {
 		auto directRaf = std::static_pointer_cast<DirectUringRandomAccessFile>(raf);
 		return directRaf->readAsync(length, std::move(buffer), index);
 	} else if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "aio") {
+#ifdef ENABLE_LIBAIO
+		auto directRaf = std::static_pointer_cast<DirectAioRandomAccessFile>(raf);
+		return directRaf->readAsync(length, std::move(buffer), index);
+#else
 		throw InvalidArgumentException("PhysicalLocalReader::readAsync: We don't support aio for our async read yet.");
+#endif
 	} else {
 		throw InvalidArgumentException("PhysicalLocalReader::readAsync: the async read method is unknown. ");
 	}
 
 }
 
+std::shared_ptr<ByteBuffer> PhysicalLocalReader::readAsync(int length, std::shared_ptr<ByteBuffer> buffer, int index,
+                                                           const std::vector<int64_t> &bufferIds) {
+	numRequests++;
+	if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "iouring") {
+		auto directRaf = std::static_pointer_cast<DirectUringRandomAccessFile>(raf);
+		return directRaf->readAsync(length, std::move(buffer), index, bufferIds);
+	} else if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "aio") {
+#ifdef ENABLE_LIBAIO
+		auto directRaf = std::static_pointer_cast<DirectAioRandomAccessFile>(raf);
+		return directRaf->readAsync(length, std::move(buffer), index, bufferIds);
+#else
+		throw InvalidArgumentException("PhysicalLocalReader::readAsync: We don't support aio for our async read yet.");
+#endif
+	} else {
+		throw InvalidArgumentException("PhysicalLocalReader::readAsync: the async read method is unknown. ");
+	}
+}
+
 void PhysicalLocalReader::readAsyncSubmit(uint32_t size) {
 	numRequests++;
 	if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "iouring") {
 		auto directRaf = std::static_pointer_cast<DirectUringRandomAccessFile>(raf);
 		directRaf->readAsyncSubmit(size);
 	} else if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "aio") {
+#ifdef ENABLE_LIBAIO
+		auto directRaf = std::static_pointer_cast<DirectAioRandomAccessFile>(raf);
+		directRaf->readAsyncSubmit(size);
+#else
 		throw InvalidArgumentException("PhysicalLocalReader::readAsync: We don't support aio for our async read yet.");
+#endif
 	} else {
 		throw InvalidArgumentException("PhysicalLocalReader::readAsync: the async read method is unknown. ");
 	}
 }
 
-void PhysicalLocalReader::readAsyncComplete(uint32_t size) {
+void PhysicalLocalReader::readAsyncComplete(uint32_t size, int slot) {
 	numRequests++;
 	if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "iouring") {
 		auto directRaf = std::static_pointer_cast<DirectUringRandomAccessFile>(raf);
-		directRaf->readAsyncComplete(size);
+		directRaf->readAsyncComplete(size, slot);
 	} else if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "aio") {
+#ifdef ENABLE_LIBAIO
+		auto directRaf = std::static_pointer_cast<DirectAioRandomAccessFile>(raf);
+		directRaf->readAsyncComplete(size, slot);
+#else
 		throw InvalidArgumentException("PhysicalLocalReader::readAsync: We don't support aio for our async read yet.");
+#endif
 	} else {
 		throw InvalidArgumentException("PhysicalLocalReader::readAsync: the async read method is unknown. ");
 	}
 }
 
-void PhysicalLocalReader::readAsyncSubmitAndComplete(uint32_t size){
+bool PhysicalLocalReader::readAsyncComplete(int64_t bufferId, bool wait) {
+	if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "iouring") {
+		auto directRaf = std::static_pointer_cast<DirectUringRandomAccessFile>(raf);
+		return directRaf->readAsyncComplete(bufferId, wait);
+	} else if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "aio") {
+#ifdef ENABLE_LIBAIO
+		auto directRaf = std::static_pointer_cast<DirectAioRandomAccessFile>(raf);
+		return directRaf->readAsyncComplete(bufferId, wait);
+#else
+		throw InvalidArgumentException("PhysicalLocalReader::readAsync: We don't support aio for our async read yet.");
+#endif
+	} else {
+		throw InvalidArgumentException("PhysicalLocalReader::readAsync: the async read method is unknown. ");
+	}
+}
+
+void PhysicalLocalReader::readAsyncSubmitAndComplete(uint32_t size, int slot){
 	numRequests++;
 	if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "iouring") {
 		auto directRaf = std::static_pointer_cast<DirectUringRandomAccessFile>(raf);
 		directRaf->readAsyncSubmit(size);
 		::TimeProfiler::Instance().Start("async wait");
-		directRaf->readAsyncComplete(size);
+		directRaf->readAsyncComplete(size, slot);
 		::TimeProfiler::Instance().End("async wait");
 	} else if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "aio") {
+#ifdef ENABLE_LIBAIO
+		auto directRaf = std::static_pointer_cast<DirectAioRandomAccessFile>(raf);
+		directRaf->readAsyncSubmit(size);
+		::TimeProfiler::Instance().Start("async wait");
+		directRaf->readAsyncComplete(size, slot);
+		::TimeProfiler::Instance().End("async wait");
+#else
 		throw InvalidArgumentException("PhysicalLocalReader::readAsync: We don't support aio for our async read yet.");
+#endif
 	} else {
 		throw InvalidArgumentException("PhysicalLocalReader::readAsync: the async read method is unknown. ");
 	}
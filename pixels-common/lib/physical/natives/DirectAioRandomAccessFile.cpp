@@ -0,0 +1,209 @@
+#include "physical/natives/DirectAioRandomAccessFile.h"
+#include <cstring>
+#include <cerrno>
+
+const int DirectAioRandomAccessFile::QUEUE_DEPTH = 4096;
+const int DirectAioRandomAccessFile::EVENT_BATCH_SIZE = 64;
+const uint64_t DirectAioRandomAccessFile::MERGED_READ_TAG = (uint64_t) 1 << 63;
+thread_local io_context_t DirectAioRandomAccessFile::context = nullptr;
+thread_local bool DirectAioRandomAccessFile::isInitialized = false;
+thread_local std::vector<struct iocb> DirectAioRandomAccessFile::pendingIocbs;
+thread_local int DirectAioRandomAccessFile::inflightNum = 0;
+thread_local std::vector<int> DirectAioRandomAccessFile::completedNum;
+thread_local std::vector<int> DirectAioRandomAccessFile::completedBuffers;
+thread_local std::unordered_map<uint64_t, std::vector<int64_t>> DirectAioRandomAccessFile::mergedReads;
+thread_local uint64_t DirectAioRandomAccessFile::nextMergedRead = 0;
+thread_local AsyncReadSampler DirectAioRandomAccessFile::sampler;
+thread_local DirectAioRandomAccessFile::ContextReleaser DirectAioRandomAccessFile::contextReleaser;
+
+DirectAioRandomAccessFile::DirectAioRandomAccessFile(const std::string &file) : DirectRandomAccessFile(file) {
+
+}
+
+void DirectAioRandomAccessFile::Initialize() {
+	if(!isInitialized) {
+		// make sure the context is released when this thread exits
+		(void) contextReleaser;
+		context = nullptr;
+		int ret = io_setup(QUEUE_DEPTH, &context);
+		if(ret < 0) {
+			throw InvalidArgumentException("DirectAioRandomAccessFile: initialize aio context fails: "
+			                               + std::string(strerror(-ret)));
+		}
+		isInitialized = true;
+		inflightNum = 0;
+	}
+}
+
+void DirectAioRandomAccessFile::Reset() {
+	if(isInitialized) {
+		// the buffer pool releases the buffers after the scan, so the kernel must not write them anymore
+		pendingIocbs.clear();
+		while(inflightNum > 0) {
+			reapCompletions(true);
+		}
+	}
+	completedNum.clear();
+	completedBuffers.clear();
+	mergedReads.clear();
+	sampler.reset();
+}
+
+DirectAioRandomAccessFile::ContextReleaser::~ContextReleaser() {
+	if(isInitialized) {
+		io_destroy(context);
+		context = nullptr;
+		isInitialized = false;
+	}
+}
+
+std::shared_ptr<ByteBuffer> DirectAioRandomAccessFile::readAsync(int length, std::shared_ptr<ByteBuffer> buffer, int index) {
+	// each read is tagged with the buffer id it reads into
+	return prepareRead(length, std::move(buffer), (uint64_t) index);
+}
+
+std::shared_ptr<ByteBuffer> DirectAioRandomAccessFile::readAsync(int length, std::shared_ptr<ByteBuffer> buffer, int index,
+                                                                 const std::vector<int64_t> &bufferIds) {
+	uint64_t key = nextMergedRead++ % MERGED_READ_TAG;
+	mergedReads[key] = bufferIds;
+	return prepareRead(length, std::move(buffer), MERGED_READ_TAG | key);
+}
+
+std::shared_ptr<ByteBuffer> DirectAioRandomAccessFile::prepareRead(int length, std::shared_ptr<ByteBuffer> buffer, uint64_t tag) {
+	sampler.prepare(path, tag, length, pendingIocbs.empty() && inflightNum == 0);
+	pendingIocbs.emplace_back();
+	struct iocb * iocb = &pendingIocbs.back();
+	std::shared_ptr<ByteBuffer> result;
+	if(enableDirect) {
+		// the file will be read from blockStart(fileOffset), and the first fileDelta bytes should be ignored.
+		uint64_t fileOffsetAligned = directIoLib->blockStart(offset);
+		uint64_t toRead = directIoLib->blockEnd(offset + length) - directIoLib->blockStart(offset);
+		io_prep_pread(iocb, fd, buffer->getPointer(), toRead, (long long) fileOffsetAligned);
+		result = std::make_shared<ByteBuffer>(*buffer, offset - fileOffsetAligned, length);
+	} else {
+		io_prep_pread(iocb, fd, buffer->getPointer(), length, offset);
+		result = std::make_shared<ByteBuffer>(*buffer, 0, length);
+	}
+	iocb->data = (void *) (uintptr_t) tag;
+	seek(offset + length);
+	return result;
+}
+
+void DirectAioRandomAccessFile::readAsyncSubmit(int size) {
+	// the kernel copies the iocbs when they are submitted, so they can be released afterwards
+	std::vector<struct iocb *> iocbs;
+	iocbs.reserve(pendingIocbs.size());
+	for(auto &iocb : pendingIocbs) {
+		iocbs.emplace_back(&iocb);
+	}
+	if(!iocbs.empty()) {
+		sampler.submit();
+	}
+	int submitted = 0;
+	while(submitted < iocbs.size()) {
+		int ret = io_submit(context, (long) (iocbs.size() - submitted), iocbs.data() + submitted);
+		if((ret == -EAGAIN || ret == 0) && inflightNum > 0) {
+			// the context is full, so consume the completions before submitting the rest
+			reapCompletions(true);
+			continue;
+		}
+		if(ret <= 0) {
+			pendingIocbs.clear();
+			throw InvalidArgumentException("DirectAioRandomAccessFile::readAsyncSubmit: submit fails: "
+			                               + std::string(strerror(-ret)));
+		}
+		submitted += ret;
+		inflightNum += ret;
+	}
+	pendingIocbs.clear();
+}
+
+void DirectAioRandomAccessFile::reapCompletions(bool wait) {
+	struct io_event events[EVENT_BATCH_SIZE];
+	int count = io_getevents(context, wait ? 1 : 0, EVENT_BATCH_SIZE, events, nullptr);
+	while(count == -EINTR) {
+		count = io_getevents(context, wait ? 1 : 0, EVENT_BATCH_SIZE, events, nullptr);
+	}
+	if(count < 0) {
+		throw InvalidArgumentException("DirectAioRandomAccessFile::readAsyncComplete: get events fails: "
+		                               + std::string(strerror(-count)));
+	}
+	long error = 0;
+	for(int i = 0; i < count; i++) {
+		if((long) events[i].res < 0) {
+			error = -(long) events[i].res;
+		}
+		countCompletion((uint64_t) (uintptr_t) events[i].data);
+	}
+	inflightNum -= count;
+	if(error != 0) {
+		throw InvalidArgumentException("DirectAioRandomAccessFile::readAsyncComplete: read fails: "
+		                               + std::string(strerror((int) error)));
+	}
+}
+
+void DirectAioRandomAccessFile::countCompletion(uint64_t tag) {
+	sampler.complete(tag);
+	std::vector<int64_t> bufferIds;
+	if(tag & MERGED_READ_TAG) {
+		auto it = mergedReads.find(tag & ~MERGED_READ_TAG);
+		if(it == mergedReads.end()) {
+			return;
+		}
+		bufferIds = std::move(it->second);
+		mergedReads.erase(it);
+	} else {
+		bufferIds.emplace_back((int64_t) tag);
+	}
+	for(auto bufferId : bufferIds) {
+		int slot = ::BufferPool::GetBufferSlot(bufferId);
+		if(completedNum.size() <= slot) {
+			completedNum.resize(slot + 1, 0);
+		}
+		completedNum.at(slot)++;
+		if(completedBuffers.size() <= bufferId) {
+			completedBuffers.resize(bufferId + 1, 0);
+		}
+		completedBuffers.at(bufferId)++;
+	}
+}
+
+void DirectAioRandomAccessFile::readAsyncComplete(int size, int slot) {
+	if(completedNum.size() <= slot) {
+		completedNum.resize(slot + 1, 0);
+	}
+	while(completedNum.at(slot) < size) {
+		reapCompletions(true);
+	}
+	completedNum.at(slot) -= size;
+	// all the reads of the slot are waited for, so are the reads of its buffers
+	int64_t firstBufferId = ::BufferPool::GetBufferId(0, slot);
+	for(int64_t bufferId = firstBufferId;
+	    bufferId < firstBufferId + ::BufferPool::colCount && bufferId < completedBuffers.size(); bufferId++) {
+		completedBuffers.at(bufferId) = 0;
+	}
+}
+
+bool DirectAioRandomAccessFile::readAsyncComplete(int64_t bufferId, bool wait) {
+	if(!isInitialized) {
+		return true;
+	}
+	if(completedBuffers.size() <= bufferId) {
+		completedBuffers.resize(bufferId + 1, 0);
+	}
+	if(completedBuffers.at(bufferId) == 0 && inflightNum > 0) {
+		reapCompletions(false);
+	}
+	while(wait && completedBuffers.at(bufferId) == 0) {
+		if(inflightNum == 0) {
+			throw InvalidArgumentException("DirectAioRandomAccessFile::readAsyncComplete: the read is not submitted");
+		}
+		reapCompletions(true);
+	}
+	if(completedBuffers.at(bufferId) == 0) {
+		return false;
+	}
+	completedBuffers.at(bufferId)--;
+	completedNum.at(::BufferPool::GetBufferSlot(bufferId))--;
+	return true;
+}
@@ -2,140 +2,394 @@
 // Created by liyu on 5/28/23.
 //
 #include "physical/natives/DirectUringRandomAccessFile.h"
+#include "utils/ConfigFactory.h"
+#include <cstring>
 
+const int DirectUringRandomAccessFile::QUEUE_DEPTH = 4096;
+const int DirectUringRandomAccessFile::FIXED_FILE_NUM = 64;
+const int DirectUringRandomAccessFile::CQE_BATCH_SIZE = 64;
+const uint64_t DirectUringRandomAccessFile::MERGED_READ_TAG = (uint64_t) 1 << 63;
 thread_local struct io_uring * DirectUringRandomAccessFile::ring = nullptr;
 thread_local bool DirectUringRandomAccessFile::isRegistered = false;
 thread_local struct iovec * DirectUringRandomAccessFile::iovecs = nullptr;
 thread_local uint32_t DirectUringRandomAccessFile::iovecSize = 0;
+thread_local uint32_t DirectUringRandomAccessFile::iovecCapacity = 0;
+thread_local DirectUringRandomAccessFile::RingReleaser DirectUringRandomAccessFile::ringReleaser;
+thread_local std::vector<int> DirectUringRandomAccessFile::completedNum;
+thread_local std::vector<int> DirectUringRandomAccessFile::completedBuffers;
+thread_local std::unordered_map<uint64_t, std::vector<int64_t>> DirectUringRandomAccessFile::mergedReads;
+thread_local uint64_t DirectUringRandomAccessFile::nextMergedRead = 0;
+thread_local AsyncReadSampler DirectUringRandomAccessFile::sampler;
+thread_local int DirectUringRandomAccessFile::pendingNum = 0;
+thread_local int DirectUringRandomAccessFile::inflightNum = 0;
+thread_local bool DirectUringRandomAccessFile::sqpoll = false;
+thread_local std::vector<int> DirectUringRandomAccessFile::fixedFiles;
+thread_local uint32_t DirectUringRandomAccessFile::nextFixedFile = 0;
 
 DirectUringRandomAccessFile::DirectUringRandomAccessFile(const std::string &file) : DirectRandomAccessFile(file) {
-
+	fixedRing = nullptr;
+	fixedFileIndex = -1;
 }
 
 void DirectUringRandomAccessFile::RegisterBufferFromPool(std::vector<uint32_t> colIds) {
     std::vector<std::shared_ptr<ByteBuffer>> tmpBuffers;
-    if(!isRegistered) {
-        for(auto buffer : ::BufferPool::buffers) {
-            for(auto colId : colIds) {
-                tmpBuffers.emplace_back(buffer[colId]);
-            }
-        }
-        iovecs = (iovec *)calloc(tmpBuffers.size() ,sizeof(struct iovec));
-        iovecSize = tmpBuffers.size();
-        for(auto i = 0; i < tmpBuffers.size(); i++) {
-            auto buffer = tmpBuffers.at(i);
-            iovecs[i].iov_base = buffer->getPointer();
-            iovecs[i].iov_len = buffer->size();
-            memset(iovecs[i].iov_base, 0, buffer->size());
-        }
-        int ret = io_uring_register_buffers(ring, iovecs, iovecSize);
-        if(ret != 0) {
-            throw InvalidArgumentException("DirectUringRandomAccessFile::RegisterBuffer: register buffer fails. ");
+    for(auto buffer : ::BufferPool::buffers) {
+        for(auto colId : colIds) {
+            tmpBuffers.emplace_back(buffer[colId]);
         }
-        isRegistered = true;
     }
+    registerBuffers(tmpBuffers);
 }
 
-
-
 void DirectUringRandomAccessFile::RegisterBuffer(std::vector<std::shared_ptr<ByteBuffer>> buffers) {
-	if(!isRegistered) {
-		iovecs = (iovec *)calloc(buffers.size() ,sizeof(struct iovec));
-		iovecSize = buffers.size();
-		for(auto i = 0; i < buffers.size(); i++) {
-			auto buffer = buffers.at(i);
-			iovecs[i].iov_base = buffer->getPointer();
-			iovecs[i].iov_len = buffer->size();
-			memset(iovecs[i].iov_base, 0, buffer->size());
+	registerBuffers(buffers);
+}
+
+void DirectUringRandomAccessFile::registerBuffers(const std::vector<std::shared_ptr<ByteBuffer>> &poolBuffers) {
+	// the buffers not allocated yet take the place of a small placeholder, so that
+	// the buffer ids of the allocated ones stay the same
+	static auto placeholder = std::make_shared<ByteBuffer>(4096);
+	std::vector<std::shared_ptr<ByteBuffer>> buffers;
+	buffers.reserve(poolBuffers.size());
+	for(auto &buffer : poolBuffers) {
+		buffers.emplace_back(buffer == nullptr ? placeholder : buffer);
+	}
+	if(isRegistered && iovecSize == buffers.size()) {
+		bool changed = false;
+		for(int i = 0; i < buffers.size(); i++) {
+			if(iovecs[i].iov_base != buffers.at(i)->getPointer() || iovecs[i].iov_len != buffers.at(i)->size()) {
+				changed = true;
+				break;
+			}
 		}
-		int ret = io_uring_register_buffers(ring, iovecs, iovecSize);
-		if(ret != 0) {
-			throw InvalidArgumentException("DirectUringRandomAccessFile::RegisterBuffer: register buffer fails. ");
+		if(!changed) {
+			return;
+		}
+	}
+	uint32_t newSize = buffers.size();
+	auto * newIovecs = (iovec *)calloc(std::max(newSize, iovecCapacity), sizeof(struct iovec));
+	for(auto i = 0; i < buffers.size(); i++) {
+		auto buffer = buffers.at(i);
+		newIovecs[i].iov_base = buffer->getPointer();
+		newIovecs[i].iov_len = buffer->size();
+		// touch the pages of the new buffers. The registered ones may hold the data being read or decoded
+		if(!isRegistered || i >= iovecSize || iovecs[i].iov_base != newIovecs[i].iov_base) {
+			memset(newIovecs[i].iov_base, 0, buffer->size());
 		}
-		isRegistered = true;
 	}
+	if(iovecCapacity > 0 && newSize <= iovecCapacity) {
+		// the unused entries are updated to empty, so that the ring releases the old buffers
+		if(io_uring_register_buffers_update_tag(ring, 0, newIovecs, nullptr, iovecCapacity) != (int) iovecCapacity) {
+			free(newIovecs);
+			throw InvalidArgumentException("DirectUringRandomAccessFile::RegisterBuffer: update buffer fails. ");
+		}
+	} else {
+		if(isRegistered) {
+			io_uring_unregister_buffers(ring);
+			isRegistered = false;
+		}
+		if(io_uring_register_buffers_sparse(ring, newSize) == 0) {
+			iovecCapacity = newSize;
+			if(io_uring_register_buffers_update_tag(ring, 0, newIovecs, nullptr, newSize) != (int) newSize) {
+				free(newIovecs);
+				throw InvalidArgumentException("DirectUringRandomAccessFile::RegisterBuffer: update buffer fails. ");
+			}
+		} else {
+			// the kernel doesn't support updating the registered buffers
+			iovecCapacity = 0;
+			if(io_uring_register_buffers(ring, newIovecs, newSize) != 0) {
+				free(newIovecs);
+				throw InvalidArgumentException("DirectUringRandomAccessFile::RegisterBuffer: register buffer fails. ");
+			}
+		}
+	}
+	if(iovecs != nullptr) {
+		free(iovecs);
+	}
+	iovecs = newIovecs;
+	iovecSize = newSize;
+	isRegistered = true;
 }
 
 void DirectUringRandomAccessFile::Initialize() {
 	// initialize io_uring ring
 	if(ring == nullptr) {
+		// make sure the ring is released when this thread exits
+		(void) ringReleaser;
 		ring = new io_uring();
-		if(io_uring_queue_init(4096, ring, 0) < 0) {
+		struct io_uring_params params;
+		memset(&params, 0, sizeof(params));
+		if(ConfigFactory::Instance().boolCheckProperty("localfs.iouring.sqpoll")) {
+			// a kernel thread polls the submission queue, so submitting the reads needs no syscall
+			params.flags |= IORING_SETUP_SQPOLL;
+			params.sq_thread_idle = std::stoi(ConfigFactory::Instance().getProperty("localfs.iouring.sqpoll.idle"));
+		}
+		int ret = io_uring_queue_init_params(QUEUE_DEPTH, ring, &params);
+		if(ret < 0 && (params.flags & IORING_SETUP_SQPOLL)) {
+			// SQPOLL may need privileges that the process doesn't have, so use a plain ring instead
+			memset(&params, 0, sizeof(params));
+			ret = io_uring_queue_init_params(QUEUE_DEPTH, ring, &params);
+		}
+		if(ret < 0) {
 			throw InvalidArgumentException("DirectRandomAccessFile: initialize io_uring fails.");
 		}
+		sqpoll = params.flags & IORING_SETUP_SQPOLL;
+		pendingNum = 0;
+		inflightNum = 0;
+		nextFixedFile = 0;
+		fixedFiles.clear();
+		if(ConfigFactory::Instance().boolCheckProperty("localfs.iouring.register.files")) {
+			// register an empty table, the files take their places when they are read
+			std::vector<int> files(FIXED_FILE_NUM, -1);
+			if(io_uring_register_files(ring, files.data(), files.size()) == 0) {
+				fixedFiles = files;
+			}
+		}
 	}
 }
 
 void DirectUringRandomAccessFile::Reset() {
     // Important! Because sometimes ring is nullptr here.
     // For example, two threads A and B share the same global state. If A finish all files while B just starts,
-    // B would execute Reset function from InitLocal. If we don't set this 'if' branch, ring would be double freed.
+    // B would execute Reset function from InitLocal.
+    if(ring != nullptr) {
+        // the buffer pool releases the buffers after the scan, so the kernel must not write them anymore
+        submitPending();
+        while(inflightNum > 0) {
+            reapCompletions(true);
+        }
+    }
+    completedNum.clear();
+    completedBuffers.clear();
+    mergedReads.clear();
+    sampler.reset();
+}
+
+DirectUringRandomAccessFile::RingReleaser::~RingReleaser() {
     if(ring != nullptr) {
-        // We don't use this function anymore since it slows down the speed
-        //		if(io_uring_unregister_buffers(ring) != 0) {
-        //			throw InvalidArgumentException("DirectUringRandomAccessFile::UnregisterBuffer: unregister buffer fails. ");
-        //		}
         io_uring_queue_exit(ring);
         delete(ring);
         ring = nullptr;
-        isRegistered = false;
     }
+    isRegistered = false;
+    iovecCapacity = 0;
+    iovecSize = 0;
     if(iovecs != nullptr) {
         free(iovecs);
         iovecs = nullptr;
     }
 }
 
+void DirectUringRandomAccessFile::close() {
+	// release the registered file, otherwise the ring keeps the file open
+	if(fixedRing != nullptr && fixedRing == ring && fixedFileIndex < fixedFiles.size()
+	   && fixedFiles.at(fixedFileIndex) == fd) {
+		int emptyFd = -1;
+		io_uring_register_files_update(ring, fixedFileIndex, &emptyFd, 1);
+		fixedFiles.at(fixedFileIndex) = -1;
+	}
+	fixedRing = nullptr;
+	fixedFileIndex = -1;
+	DirectRandomAccessFile::close();
+}
+
 DirectUringRandomAccessFile::~DirectUringRandomAccessFile() {
 
 }
 
+int DirectUringRandomAccessFile::getFixedFileIndex() {
+	if(fixedFiles.empty()) {
+		return -1;
+	}
+	if(fixedRing == ring && fixedFileIndex >= 0 && fixedFileIndex < fixedFiles.size()
+	   && fixedFiles.at(fixedFileIndex) == fd) {
+		return fixedFileIndex;
+	}
+	// the indexes are taken in turn, so the file registered the longest ago is replaced
+	int index = (int) (nextFixedFile++ % fixedFiles.size());
+	int newFd = fd;
+	if(io_uring_register_files_update(ring, index, &newFd, 1) != 1) {
+		return -1;
+	}
+	fixedFiles.at(index) = fd;
+	fixedRing = ring;
+	fixedFileIndex = index;
+	return index;
+}
+
+struct io_uring_sqe * DirectUringRandomAccessFile::getSqe() {
+	struct io_uring_sqe * sqe = io_uring_get_sqe(ring);
+	while(sqe == nullptr) {
+		// the submission queue is full, e.g., when reading hundreds of columns
+		submitPending();
+		if(sqpoll) {
+			// the polling thread may not have taken the entries yet
+			io_uring_sqring_wait(ring);
+		}
+		sqe = io_uring_get_sqe(ring);
+	}
+	return sqe;
+}
+
+void DirectUringRandomAccessFile::submitPending() {
+	if(pendingNum > 0) {
+		sampler.submit();
+	}
+	while(pendingNum > 0) {
+		int ret = io_uring_submit(ring);
+		if(ret == -EAGAIN || ret == -EBUSY || (ret == 0 && inflightNum > 0)) {
+			// the kernel is short of resources or the completion queue is full,
+			// so consume the completions before submitting the rest
+			reapCompletions(true);
+			continue;
+		}
+		if(ret <= 0) {
+			throw InvalidArgumentException("DirectUringRandomAccessFile::readAsyncSubmit: submit fails: "
+			                               + std::string(strerror(-ret)));
+		}
+		pendingNum -= ret;
+		inflightNum += ret;
+	}
+}
+
+void DirectUringRandomAccessFile::reapCompletions(bool wait) {
+	struct io_uring_cqe *cqes[CQE_BATCH_SIZE];
+	unsigned count = io_uring_peek_batch_cqe(ring, cqes, CQE_BATCH_SIZE);
+	if(count == 0 && wait) {
+		if(io_uring_wait_cqe_nr(ring, cqes, 1) != 0) {
+			throw InvalidArgumentException("DirectUringRandomAccessFile::readAsyncComplete: wait cqe fails");
+		}
+		count = io_uring_peek_batch_cqe(ring, cqes, CQE_BATCH_SIZE);
+	}
+	int error = 0;
+	for(unsigned i = 0; i < count; i++) {
+		if(cqes[i]->res < 0) {
+			error = -cqes[i]->res;
+		}
+		countCompletion((uint64_t) (uintptr_t) io_uring_cqe_get_data(cqes[i]));
+	}
+	// the completions are consumed before reporting the error, so that the ring stays usable
+	io_uring_cq_advance(ring, count);
+	inflightNum -= (int) count;
+	if(error != 0) {
+		throw InvalidArgumentException("DirectUringRandomAccessFile::readAsyncComplete: read fails: "
+		                               + std::string(strerror(error)));
+	}
+}
+
 std::shared_ptr<ByteBuffer> DirectUringRandomAccessFile::readAsync(int length, std::shared_ptr<ByteBuffer> buffer, int index) {
+	// each read is tagged with the buffer id it reads into
+	return prepareRead(length, std::move(buffer), index, (uint64_t) index);
+}
+
+std::shared_ptr<ByteBuffer> DirectUringRandomAccessFile::readAsync(int length, std::shared_ptr<ByteBuffer> buffer, int index,
+                                                                   const std::vector<int64_t> &bufferIds) {
+	uint64_t key = nextMergedRead++ % MERGED_READ_TAG;
+	mergedReads[key] = bufferIds;
+	return prepareRead(length, std::move(buffer), index, MERGED_READ_TAG | key);
+}
+
+std::shared_ptr<ByteBuffer> DirectUringRandomAccessFile::prepareRead(int length, std::shared_ptr<ByteBuffer> buffer,
+                                                                     int index, uint64_t tag) {
+	sampler.prepare(path, tag, length, pendingNum == 0 && inflightNum == 0);
+	struct io_uring_sqe * sqe = getSqe();
+	int fileIndex = getFixedFileIndex();
+	pendingNum++;
+	std::shared_ptr<ByteBuffer> result;
 	if(enableDirect) {
-		struct io_uring_sqe * sqe = io_uring_get_sqe(ring);
 //		if(length > iovecs[index].iov_len) {
 //			throw InvalidArgumentException("DirectUringRandomAccessFile::readAsync: the length is larger than buffer length.");
 //		}
 		// the file will be read from blockStart(fileOffset), and the first fileDelta bytes should be ignored.
 		uint64_t fileOffsetAligned = directIoLib->blockStart(offset);
 		uint64_t toRead = directIoLib->blockEnd(offset + length) - directIoLib->blockStart(offset);
-        io_uring_prep_read_fixed(sqe, fd, buffer->getPointer(), toRead,
+        io_uring_prep_read_fixed(sqe, fileIndex >= 0 ? fileIndex : fd, buffer->getPointer(), toRead,
 		                         fileOffsetAligned, index);
-		auto bb = std::make_shared<ByteBuffer>(*buffer,
-		                                       offset - fileOffsetAligned, length);
-		seek(offset + length);
-		return bb;
+		result = std::make_shared<ByteBuffer>(*buffer, offset - fileOffsetAligned, length);
 	} else {
-		struct io_uring_sqe * sqe = io_uring_get_sqe(ring);
 //		if(length > iovecs[index].iov_len) {
 //			throw InvalidArgumentException("DirectUringRandomAccessFile::readAsync: the length is larger than buffer length.");
 //		}
-		io_uring_prep_read_fixed(sqe, fd, buffer->getPointer(), length, offset, index);
-		seek(offset + length);
-		auto result = std::make_shared<ByteBuffer>(*buffer, 0, length);
-		return result;
+		io_uring_prep_read_fixed(sqe, fileIndex >= 0 ? fileIndex : fd, buffer->getPointer(), length, offset, index);
+		result = std::make_shared<ByteBuffer>(*buffer, 0, length);
 	}
-
+	// the prep call resets the flags of the entry, so the fixed file flag must be set after it.
+	// Otherwise, the index in the fixed file table is taken as a file descriptor
+	if(fileIndex >= 0) {
+		io_uring_sqe_set_flags(sqe, IOSQE_FIXED_FILE);
+	}
+	io_uring_sqe_set_data(sqe, (void *) (uintptr_t) tag);
+	seek(offset + length);
+	return result;
 }
 
 
 void DirectUringRandomAccessFile::readAsyncSubmit(int size) {
-	int ret = io_uring_submit(ring);
-	if(ret != size) {
-		throw InvalidArgumentException("DirectUringRandomAccessFile::readAsyncSubmit: submit fails");
-	}
+	submitPending();
 }
 
-void DirectUringRandomAccessFile::readAsyncComplete(int size) {
+void DirectUringRandomAccessFile::readAsyncComplete(int size, int slot) {
 	// Important! We cannot write the code as io_uring_wait_cqe_nr(ring, &cqe, iovecSize).
 	// The reason is unclear, but some random bugs would happen. It takes me nearly a week to find this bug
-	struct io_uring_cqe *cqe;
-	for(int i = 0; i < size; i++) {
-		if(io_uring_wait_cqe_nr(ring, &cqe, 1) != 0) {
-			throw InvalidArgumentException("DirectUringRandomAccessFile::readAsyncComplete: wait cqe fails");
-		}
-		io_uring_cqe_seen(ring, cqe);
+	if(completedNum.size() <= slot) {
+		completedNum.resize(slot + 1, 0);
+	}
+	while(completedNum.at(slot) < size) {
+		reapCompletions(true);
+	}
+	completedNum.at(slot) -= size;
+	// all the reads of the slot are waited for, so are the reads of its buffers
+	int64_t firstBufferId = ::BufferPool::GetBufferId(0, slot);
+	for(int64_t bufferId = firstBufferId;
+	    bufferId < firstBufferId + ::BufferPool::colCount && bufferId < completedBuffers.size(); bufferId++) {
+		completedBuffers.at(bufferId) = 0;
 	}
 }
 
+bool DirectUringRandomAccessFile::readAsyncComplete(int64_t bufferId, bool wait) {
+	if(ring == nullptr) {
+		// the ring is already reset, together with the reads in flight
+		return true;
+	}
+	if(completedBuffers.size() <= bufferId) {
+		completedBuffers.resize(bufferId + 1, 0);
+	}
+	if(completedBuffers.at(bufferId) == 0) {
+		reapCompletions(false);
+	}
+	while(wait && completedBuffers.at(bufferId) == 0) {
+		reapCompletions(true);
+	}
+	if(completedBuffers.at(bufferId) == 0) {
+		return false;
+	}
+	completedBuffers.at(bufferId)--;
+	completedNum.at(::BufferPool::GetBufferSlot(bufferId))--;
+	return true;
+}
 
+void DirectUringRandomAccessFile::countCompletion(uint64_t tag) {
+	sampler.complete(tag);
+	std::vector<int64_t> bufferIds;
+	if(tag & MERGED_READ_TAG) {
+		auto it = mergedReads.find(tag & ~MERGED_READ_TAG);
+		if(it == mergedReads.end()) {
+			return;
+		}
+		bufferIds = std::move(it->second);
+		mergedReads.erase(it);
+	} else {
+		bufferIds.emplace_back((int64_t) tag);
+	}
+	for(auto bufferId : bufferIds) {
+		int slot = ::BufferPool::GetBufferSlot(bufferId);
+		if(completedNum.size() <= slot) {
+			completedNum.resize(slot + 1, 0);
+		}
+		completedNum.at(slot)++;
+		if(completedBuffers.size() <= bufferId) {
+			completedBuffers.resize(bufferId + 1, 0);
+		}
+		completedBuffers.at(bufferId)++;
+	}
+}
@@ -0,0 +1,95 @@
+#include "physical/natives/MmapRandomAccessFile.h"
+#include "utils/ConfigFactory.h"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+FileMapping::~FileMapping() {
+    if(address != nullptr) {
+        munmap(address, length);
+    }
+}
+
+MmapByteBuffer::MmapByteBuffer(std::shared_ptr<FileMapping> mapping, long offset, uint32_t length)
+    : ByteBuffer(mapping->address + offset, length, false), mapping(std::move(mapping)) {
+    // the memory belongs to the mapping
+    fromOtherBB = true;
+}
+
+MmapRandomAccessFile::MmapRandomAccessFile(const std::string& file) {
+    int fd = open(file.c_str(), O_RDONLY);
+    if(fd < 0) {
+        throw std::runtime_error("MmapRandomAccessFile: File not found or fd exceeds the limitation. ");
+    }
+    struct stat fileStat;
+    if(fstat(fd, &fileStat) != 0) {
+        ::close(fd);
+        throw std::runtime_error("MmapRandomAccessFile: fail to get the file length. ");
+    }
+    len = fileStat.st_size;
+    offset = 0;
+    uint8_t * address = nullptr;
+    if(len > 0) {
+        int flags = MAP_SHARED;
+        if(ConfigFactory::Instance().boolCheckProperty("localfs.mmap.populate")) {
+            flags |= MAP_POPULATE;
+        }
+        void * mapped = mmap(nullptr, len, PROT_READ, flags, fd, 0);
+        if(mapped == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("MmapRandomAccessFile: fail to map the file. ");
+        }
+        address = (uint8_t *) mapped;
+    }
+    // the mapping stays valid after the file descriptor is closed
+    ::close(fd);
+    mapping = std::make_shared<FileMapping>(address, len);
+}
+
+void MmapRandomAccessFile::close() {
+    // the mapping is unmapped once the buffers read from it are released
+    mapping = nullptr;
+    offset = 0;
+    len = 0;
+}
+
+std::shared_ptr<ByteBuffer> MmapRandomAccessFile::readFully(int len) {
+    if(offset + len > this->len) {
+        throw std::runtime_error("MmapRandomAccessFile: read beyond the end of the file. ");
+    }
+    long pageSize = sysconf(_SC_PAGESIZE);
+    if(len >= pageSize) {
+        // start reading the pages of the chunk that are not in the page cache,
+        // madvise needs a page aligned address
+        long alignedOffset = offset / pageSize * pageSize;
+        madvise(mapping->address + alignedOffset, offset + len - alignedOffset, MADV_WILLNEED);
+    }
+    auto buffer = std::make_shared<MmapByteBuffer>(mapping, offset, len);
+    seek(offset + len);
+    return buffer;
+}
+
+std::shared_ptr<ByteBuffer> MmapRandomAccessFile::readFully(int len, std::shared_ptr<ByteBuffer> bb) {
+    return readFully(len);
+}
+
+long MmapRandomAccessFile::length() {
+    return len;
+}
+
+void MmapRandomAccessFile::seek(long off) {
+    offset = off;
+}
+
+long MmapRandomAccessFile::readLong() {
+    return readFully(sizeof(long))->getLong();
+}
+
+char MmapRandomAccessFile::readChar() {
+    return readFully(sizeof(char))->getChar();
+}
+
+int MmapRandomAccessFile::readInt() {
+    return readFully(sizeof(int))->getInt();
+}
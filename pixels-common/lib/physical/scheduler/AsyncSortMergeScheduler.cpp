@@ -0,0 +1,125 @@
+#include "physical/scheduler/AsyncSortMergeScheduler.h"
+#include "physical/io/PhysicalLocalReader.h"
+#include "physical/BufferPool.h"
+#include "physical/DeviceStatistics.h"
+#include "utils/ConfigFactory.h"
+#include <algorithm>
+#include <chrono>
+#include <numeric>
+
+Scheduler * AsyncSortMergeScheduler::instance = nullptr;
+
+Scheduler * AsyncSortMergeScheduler::Instance() {
+    if(instance == nullptr) {
+        instance = new AsyncSortMergeScheduler();
+    }
+    return instance;
+}
+
+AsyncSortMergeScheduler::AsyncSortMergeScheduler() {
+
+}
+
+std::vector<std::shared_ptr<ByteBuffer>> AsyncSortMergeScheduler::executeBatch(std::shared_ptr<PhysicalReader> reader,
+                                                                               RequestBatch batch, long queryId) {
+    return executeBatch(reader, batch, {}, queryId);
+}
+
+std::vector<std::shared_ptr<ByteBuffer>> AsyncSortMergeScheduler::executeBatch(std::shared_ptr<PhysicalReader> reader, RequestBatch batch,
+                                                                               std::vector<std::shared_ptr<ByteBuffer>> reuseBuffers, long queryId) {
+    auto requests = batch.getRequests();
+    std::vector<std::shared_ptr<ByteBuffer>> results;
+    results.resize(batch.getSize());
+    if(batch.getSize() == 0) {
+        return results;
+    }
+    auto &statistics = DeviceStatistics::Instance();
+    std::string path = reader->getPath();
+    std::vector<std::vector<int>> indexes;
+    auto mergedRequests = sortMerge(requests, indexes, statistics.getMergeGap(path), statistics.getMaxMergeSize(path));
+    if(ConfigFactory::Instance().boolCheckProperty("localfs.enable.async.io") && reuseBuffers.size() > 0) {
+        // async read
+        auto localReader = std::static_pointer_cast<PhysicalLocalReader>(reader);
+        // a merged read goes into the buffer of its first chunk, which must hold the whole range
+        std::vector<std::shared_ptr<ByteBuffer>> targets(mergedRequests.size());
+        bool grown = false;
+        for(int i = 0; i < mergedRequests.size(); i++) {
+            int first = indexes.at(i).front();
+            targets.at(i) = reuseBuffers.at(first);
+            if(indexes.at(i).size() > 1) {
+                targets.at(i) = ::BufferPool::Reserve(requests.at(first).bufferId, mergedRequests.at(i)->getLength());
+                grown |= targets.at(i) != reuseBuffers.at(first);
+            }
+        }
+        if(grown && ConfigFactory::Instance().getProperty("localfs.async.lib") == "iouring") {
+            // the reads are issued into the registered buffers, so the grown ones are registered again
+            ::DirectUringRandomAccessFile::RegisterBufferFromPool(::BufferPool::GetColumnIds());
+        }
+        for(int i = 0; i < mergedRequests.size(); i++) {
+            auto merged = mergedRequests.at(i);
+            auto &members = indexes.at(i);
+            Request first = requests.at(members.front());
+            localReader->seek(merged->getStart());
+            if(members.size() == 1) {
+                results.at(members.front()) = localReader->readAsync(merged->getLength(), targets.at(i), first.bufferId);
+                continue;
+            }
+            std::vector<int64_t> bufferIds;
+            for(int index : members) {
+                bufferIds.emplace_back(requests.at(index).bufferId);
+            }
+            auto buffer = localReader->readAsync(merged->getLength(), targets.at(i), first.bufferId, bufferIds);
+            auto separateBuffers = merged->complete(buffer);
+            for(int j = 0; j < members.size(); j++) {
+                results.at(members.at(j)) = separateBuffers.at(j);
+            }
+        }
+        localReader->readAsyncSubmit(batch.getSize());
+    } else {
+        // sync read
+        for(int i = 0; i < mergedRequests.size(); i++) {
+            auto merged = mergedRequests.at(i);
+            reader->seek(merged->getStart());
+            auto start = std::chrono::steady_clock::now();
+            auto buffer = reader->readFully(merged->getLength());
+            statistics.record(path, merged->getLength(),
+                              std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            auto separateBuffers = merged->complete(buffer);
+            for(int j = 0; j < separateBuffers.size(); j++) {
+                results.at(indexes.at(i).at(j)) = separateBuffers.at(j);
+            }
+        }
+    }
+    return results;
+}
+
+std::vector<std::shared_ptr<MergedRequest>> AsyncSortMergeScheduler::sortMerge(std::vector<Request> &requests,
+                                                                               std::vector<std::vector<int>> &indexes,
+                                                                               int maxGap, int maxLength) {
+    std::vector<int> order(requests.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&requests](int lhs, int rhs) {
+        return requests.at(lhs).start < requests.at(rhs).start;
+    });
+
+    std::vector<std::shared_ptr<MergedRequest>> mergedRequests;
+    for(int index : order) {
+        if(!mergedRequests.empty()) {
+            auto merged = mergedRequests.back()->merge(requests.at(index));
+            if(merged == mergedRequests.back()) {
+                indexes.back().emplace_back(index);
+                continue;
+            }
+            mergedRequests.emplace_back(merged);
+        } else {
+            mergedRequests.emplace_back(std::make_shared<MergedRequest>(requests.at(index), maxGap, maxLength));
+        }
+        indexes.emplace_back(std::vector<int>{index});
+    }
+    return mergedRequests;
+}
+
+AsyncSortMergeScheduler::~AsyncSortMergeScheduler() {
+    delete instance;
+    instance = nullptr;
+}
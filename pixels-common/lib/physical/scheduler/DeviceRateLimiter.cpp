@@ -0,0 +1,61 @@
+#include "physical/scheduler/DeviceRateLimiter.h"
+#include <algorithm>
+
+DeviceRateLimiter::DeviceRateLimiter(double bytesPerSecond, double opsPerSecond) {
+    this->bytesPerSecond = bytesPerSecond;
+    this->opsPerSecond = opsPerSecond;
+    // the buckets start full, so the first reads of an idle device don't wait
+    byteTokens = bytesPerSecond;
+    opTokens = opsPerSecond;
+    lastRefill = std::chrono::steady_clock::now();
+}
+
+void DeviceRateLimiter::refill() {
+    auto now = std::chrono::steady_clock::now();
+    double elapsed = std::chrono::duration<double>(now - lastRefill).count();
+    lastRefill = now;
+    byteTokens = std::min(bytesPerSecond, byteTokens + elapsed * bytesPerSecond);
+    opTokens = std::min(opsPerSecond, opTokens + elapsed * opsPerSecond);
+}
+
+void DeviceRateLimiter::acquire(long queryId, uint64_t bytes, uint64_t ops) {
+    std::unique_lock<std::mutex> lock(m);
+    if(waiters[queryId]++ == 0) {
+        turns.push_back(queryId);
+    }
+    while(true) {
+        if(turns.front() != queryId) {
+            cv.wait(lock);
+            continue;
+        }
+        refill();
+        double waitSeconds = 0;
+        if(bytesPerSecond > 0) {
+            double needed = std::min((double) bytes, bytesPerSecond);
+            waitSeconds = std::max(waitSeconds, (needed - byteTokens) / bytesPerSecond);
+        }
+        if(opsPerSecond > 0) {
+            double needed = std::min((double) ops, opsPerSecond);
+            waitSeconds = std::max(waitSeconds, (needed - opTokens) / opsPerSecond);
+        }
+        if(waitSeconds > 0) {
+            cv.wait_for(lock, std::chrono::duration<double>(waitSeconds));
+            continue;
+        }
+        if(bytesPerSecond > 0) {
+            byteTokens -= (double) bytes;
+        }
+        if(opsPerSecond > 0) {
+            opTokens -= (double) ops;
+        }
+        // the query goes to the back of the turns if it has more reads waiting
+        turns.pop_front();
+        if(--waiters[queryId] > 0) {
+            turns.push_back(queryId);
+        } else {
+            waiters.erase(queryId);
+        }
+        cv.notify_all();
+        return;
+    }
+}
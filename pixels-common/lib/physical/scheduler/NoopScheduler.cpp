@@ -5,6 +5,8 @@
 #include "physical/scheduler/NoopScheduler.h"
 #include "exception/InvalidArgumentException.h"
 #include "physical/io/PhysicalLocalReader.h"
+#include "physical/DeviceStatistics.h"
+#include <chrono>
 
 Scheduler * NoopScheduler::instance = nullptr;
 
@@ -37,15 +39,18 @@ std::vector<std::shared_ptr<ByteBuffer>> NoopScheduler::executeBatch(std::shared
         localReader->readAsyncSubmit(batch.getSize());
 	} else {
 		// sync read
+		std::string path = reader->getPath();
 		for(int i = 0; i < batch.getSize(); i++) {
 			Request request = requests[i];
 			reader->seek(request.start);
+			auto start = std::chrono::steady_clock::now();
 			if(reuseBuffers.size() > 0) {
 				results.at(i) = reader->readFully(request.length, reuseBuffers.at(i));
 			} else {
 				results.at(i) = reader->readFully(request.length);
 			}
-
+			DeviceStatistics::Instance().record(path, request.length,
+			                                    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
 		}
 	}
 	return results;
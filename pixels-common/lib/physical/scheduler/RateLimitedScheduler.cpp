@@ -0,0 +1,53 @@
+#include "physical/scheduler/RateLimitedScheduler.h"
+#include "physical/scheduler/NoopScheduler.h"
+#include "physical/StorageArrayScheduler.h"
+#include "utils/ConfigFactory.h"
+
+Scheduler * RateLimitedScheduler::instance = nullptr;
+
+Scheduler * RateLimitedScheduler::Instance() {
+    if(instance == nullptr) {
+        instance = new RateLimitedScheduler();
+    }
+    return instance;
+}
+
+RateLimitedScheduler::RateLimitedScheduler() {
+    bytesPerSecond = std::stod(ConfigFactory::Instance().getProperty("read.request.rate.limit.mbps")) * 1024 * 1024;
+    opsPerSecond = std::stod(ConfigFactory::Instance().getProperty("read.request.rate.limit.iops"));
+    if(bytesPerSecond < 0 || opsPerSecond < 0) {
+        throw InvalidArgumentException("RateLimitedScheduler: the rate limits must not be negative. ");
+    }
+}
+
+std::vector<std::shared_ptr<ByteBuffer>> RateLimitedScheduler::executeBatch(std::shared_ptr<PhysicalReader> reader,
+                                                                            RequestBatch batch, long queryId) {
+    return executeBatch(reader, batch, {}, queryId);
+}
+
+std::vector<std::shared_ptr<ByteBuffer>> RateLimitedScheduler::executeBatch(std::shared_ptr<PhysicalReader> reader, RequestBatch batch,
+                                                                            std::vector<std::shared_ptr<ByteBuffer>> reuseBuffers, long queryId) {
+    if(batch.getSize() > 0 && (bytesPerSecond > 0 || opsPerSecond > 0)) {
+        uint64_t bytes = 0;
+        for(auto &request : batch.getRequests()) {
+            bytes += request.length;
+        }
+        getLimiter(reader->getPath())->acquire(queryId, bytes, batch.getSize());
+    }
+    return NoopScheduler::Instance()->executeBatch(reader, batch, reuseBuffers, queryId);
+}
+
+std::shared_ptr<DeviceRateLimiter> RateLimitedScheduler::getLimiter(const std::string &path) {
+    std::string deviceName = StorageArrayScheduler::GetDeviceName(path);
+    std::lock_guard<std::mutex> lock(limitersMutex);
+    auto &limiter = limiters[deviceName];
+    if(limiter == nullptr) {
+        limiter = std::make_shared<DeviceRateLimiter>(bytesPerSecond, opsPerSecond);
+    }
+    return limiter;
+}
+
+RateLimitedScheduler::~RateLimitedScheduler() {
+    delete instance;
+    instance = nullptr;
+}
@@ -5,6 +5,8 @@
 #include "physical/scheduler/SortMergeScheduler.h"
 #include "utils/ConfigFactory.h"
 #include "exception/InvalidArgumentException.h"
+#include "physical/DeviceStatistics.h"
+#include <chrono>
 
 Scheduler * SortMergeScheduler::instance = nullptr;
 
@@ -27,11 +29,16 @@ std::vector<std::shared_ptr<ByteBuffer>> SortMergeScheduler::executeBatch(std::s
     if(batch.getSize() < 0) {
         return std::vector<std::shared_ptr<ByteBuffer>>{};
     }
-    auto mergeRequests = sortMerge(batch, queryId);
+    auto &statistics = DeviceStatistics::Instance();
+    std::string path = reader->getPath();
+    auto mergeRequests = sortMerge(batch, queryId, statistics.getMergeGap(path), statistics.getMaxMergeSize(path));
     std::vector<std::shared_ptr<ByteBuffer>> bbs;
     for(auto merged : mergeRequests) {
         reader->seek(merged->getStart());
+        auto start = std::chrono::steady_clock::now();
         auto buffer = reader->readFully(merged->getLength());
+        statistics.record(path, merged->getLength(),
+                          std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
         auto separateBuffers = merged->complete(buffer);
         bbs.insert(bbs.end(), separateBuffers.begin(), separateBuffers.end());
     }
@@ -43,13 +50,19 @@ SortMergeScheduler::SortMergeScheduler() {
 }
 
 std::vector<std::shared_ptr<MergedRequest>> SortMergeScheduler::sortMerge(RequestBatch batch, long queryId) {
+    return sortMerge(batch, queryId, std::stoi(ConfigFactory::Instance().getProperty("read.request.merge.gap")),
+                     std::numeric_limits<int>::max());
+}
+
+std::vector<std::shared_ptr<MergedRequest>> SortMergeScheduler::sortMerge(RequestBatch batch, long queryId,
+                                                                          int maxGap, int maxLength) {
     auto requests = batch.getRequests();
     std::sort(requests.begin(), requests.end(), [](const Request& lhs, const Request& rhs) {
         return lhs.start < rhs.start;
     });
 
     std::vector<std::shared_ptr<MergedRequest>> mergedRequests;
-    auto mr1 = std::make_shared<MergedRequest>(requests.at(0));
+    auto mr1 = std::make_shared<MergedRequest>(requests.at(0), maxGap, maxLength);
     auto mr2 = mr1;
     for(int i = 1; i < batch.getSize(); i++) {
         mr2 = mr1->merge(requests.at(i));
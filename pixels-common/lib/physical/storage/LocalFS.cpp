@@ -5,6 +5,11 @@
 #include "physical/storage/LocalFS.h"
 #include "physical/natives/DirectRandomAccessFile.h"
 #include "physical/natives/DirectUringRandomAccessFile.h"
+#ifdef ENABLE_LIBAIO
+#include "physical/natives/DirectAioRandomAccessFile.h"
+#endif
+#include "physical/natives/MmapRandomAccessFile.h"
+#include "utils/ConfigFactory.h"
 #include "physical/FilePath.h"
 #include <filesystem>
 namespace fs = std::filesystem;
@@ -31,11 +36,15 @@ std::string LocalFS::ensureSchemePrefix(const std::string &path) const {
 }
 
 std::shared_ptr<PixelsRandomAccessFile> LocalFS::openRaf(const std::string& path) {
-    if(true) {
-        // TODO: change this class to mmap class in the future.
-        return std::make_shared<DirectUringRandomAccessFile>(path);
+    if(ConfigFactory::Instance().boolCheckProperty("localfs.enable.mmap")) {
+        return std::make_shared<MmapRandomAccessFile>(path);
+#ifdef ENABLE_LIBAIO
+    } else if(ConfigFactory::Instance().boolCheckProperty("localfs.enable.async.io")
+              && ConfigFactory::Instance().getProperty("localfs.async.lib") == "aio") {
+        return std::make_shared<DirectAioRandomAccessFile>(path);
+#endif
     } else {
-        return std::make_shared<DirectRandomAccessFile>(path);
+        return std::make_shared<DirectUringRandomAccessFile>(path);
     }
 }
 
@@ -30,9 +30,33 @@ public:
     void And(long index, uint8_t value);
     bool isNone();
     void set();
+    /**
+     * Clear all bits.
+     */
+    void clear();
     void set(long index, uint8_t value);
     void setByteAligned(long index, uint8_t value);
     uint8_t get(long index);
+
+    /**
+     * @return the number of set bits in [start, start + length)
+     */
+    long count(long start, long length);
+    /**
+     * @return true if all bits in [start, start + length) are set
+     */
+    bool isAll(long start, long length);
+    /**
+     * Write the offsets (relative to start) of the set bits in [start, start + length)
+     * into sel, in increasing order. sel must hold at least length entries.
+     * @return the number of offsets written
+     */
+    long toSelection(long start, long length, uint32_t * sel);
+private:
+    /**
+     * @return the bits [index, index + bits) as a word, bits must be in [1, 64]
+     */
+    uint64_t getWord(long index, int bits);
 };
 
 #endif //DUCKDB_PIXELSBITMASK_H
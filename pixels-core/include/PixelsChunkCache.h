@@ -0,0 +1,70 @@
+#ifndef PIXELS_PIXELSCHUNKCACHE_H
+#define PIXELS_PIXELSCHUNKCACHE_H
+
+#include <string>
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <unordered_map>
+#include "physical/natives/ByteBuffer.h"
+
+/**
+ * PixelsChunkCache keeps the column chunks read by the queries of this process, keyed by
+ * (file, row group, column). It is sharded by the hash of the key, each shard has its own lock
+ * and its part of the byte budget (pixel.chunk.cache.size, 0 disables the cache).
+ * <p>
+ * A chunk is only admitted at its second miss within a while, so that a chunk scanned
+ * once doesn't evict the hot chunks. The recently missed keys are remembered in a ghost
+ * list of each shard. Admitted chunks are evicted in LRU order.
+ */
+class PixelsChunkCache {
+public:
+    PixelsChunkCache();
+    explicit PixelsChunkCache(long capacity);
+    /**
+     * @return the cache shared by all readers of this process
+     */
+    static PixelsChunkCache & Instance();
+    static std::string getCacheId(const std::string& fileCacheId, int rgId, uint32_t colId);
+    bool isEnabled();
+    /**
+     * Look up a chunk.
+     * @param key the cache id of the chunk
+     * @param admit set to true on a miss if the chunk should be put into the cache once it is read
+     * @return the cached chunk, or nullptr on a miss. The buffer is shared by all readers and
+     *         must not be moved; readers should read through a view of it.
+     */
+    std::shared_ptr<ByteBuffer> get(const std::string& key, bool& admit);
+    /**
+     * Copy a chunk into the cache.
+     */
+    void put(const std::string& key, const std::shared_ptr<ByteBuffer>& chunk);
+    uint64_t getHitCount();
+    uint64_t getMissCount();
+    long getCachedBytes();
+private:
+    struct Entry {
+        std::shared_ptr<ByteBuffer> chunk;
+        std::list<std::string>::iterator lruPosition;
+    };
+    struct Shard {
+        std::mutex lock;
+        // the most recently used key is at the front
+        std::list<std::string> lru;
+        std::unordered_map<std::string, Entry> entries;
+        // the keys missed once, the most recent one is at the front
+        std::list<std::string> ghosts;
+        std::unordered_map<std::string, std::list<std::string>::iterator> ghostPositions;
+        long bytes = 0;
+    };
+    static const int SHARD_NUM = 16;
+    static const int GHOST_NUM = 4096;
+    Shard & getShard(const std::string& key);
+    long shardCapacity;
+    std::vector<Shard> shards;
+    std::atomic<uint64_t> hitCount{0};
+    std::atomic<uint64_t> missCount{0};
+};
+
+#endif //PIXELS_PIXELSCHUNKCACHE_H
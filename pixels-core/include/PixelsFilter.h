@@ -38,5 +38,36 @@ public:
     static void FilterOperationSwitch(std::shared_ptr<ColumnVector> vector, duckdb::Value &constant,
                                       PixelsBitMask &filter_mask, std::shared_ptr<TypeDescription> type);
 
+    /**
+     * Keep only the null (isNull is true) or the non-null rows of the vector in the filter mask.
+     */
+    static void ApplyValidity(std::shared_ptr<ColumnVector> vector, PixelsBitMask &filterMask, bool isNull);
+
+    /**
+     * Get the unscaled value of a decimal constant, as the short decimals are stored in Pixels.
+     * @return false if the decimal is too wide to be stored as a short decimal
+     */
+    static bool GetUnscaledDecimal(const duckdb::Value &constant, int64_t &unscaled);
+
+    /**
+     * Check the filter against the statistic of a row group, column chunk or pixel.
+     *
+     * @param filter the pushed-down filter of the column
+     * @param statistic the min/max and null statistic of the rows to check
+     * @param type the type of the column
+     * @return false if no row described by the statistic can satisfy the filter,
+     *         true if some rows may satisfy it (or the statistic is not usable).
+     */
+    static bool CheckStatistics(duckdb::TableFilter &filter,
+                                const pixels::proto::ColumnStatistic &statistic,
+                                std::shared_ptr<TypeDescription> type);
+
+    template <class T>
+    static bool CheckRange(duckdb::ExpressionType comparisonType, T min, T max, T constant);
+
+    static bool CheckConstantStatistics(duckdb::ConstantFilter &filter,
+                                        const pixels::proto::ColumnStatistic &statistic,
+                                        std::shared_ptr<TypeDescription> type);
+
 };
 #endif //DUCKDB_PIXELSFILTER_H
@@ -9,23 +9,67 @@
 #include <string>
 #include "pixels-common/pixels.pb.h"
 #include <unordered_map>
+#include <list>
+#include <mutex>
+#include <vector>
 
 using namespace pixels::proto;
-typedef std::unordered_map<std::string, std::shared_ptr<FileTail>> FileTailTable;
-typedef std::unordered_map<std::string, std::shared_ptr<RowGroupFooter>> RGFooterTable;
 
+/**
+ * PixelsFooterCache caches the parsed FileTail and RowGroupFooter of the files.
+ * The global instance is shared by all scans and queries, so it is thread-safe. The entries
+ * are split into shards by the hash of their ids, each shard has its own lock and evicts
+ * its least recently used entries when it exceeds its part of the byte budget.
+ */
 class PixelsFooterCache {
 public:
+    /**
+     * Create a cache whose byte budget is pixel.footer.cache.size.
+     */
     PixelsFooterCache();
+    explicit PixelsFooterCache(long capacity);
+    /**
+     * @return the cache shared by all readers of this process
+     */
+    static std::shared_ptr<PixelsFooterCache> Instance();
+    /**
+     * Get the id of a file in the cache, which changes when the file is rewritten.
+     * @param path the path of the file, with or without the file:// scheme
+     * @return the path with the modification time and size of the file, or an empty string
+     *         if the file can not be stat-ed, in which case its footers should not be cached
+     */
+    static std::string getCacheId(const std::string& path);
     void putFileTail(const std::string& id, std::shared_ptr<FileTail> fileTail);
     bool containsFileTail(const std::string& id);
+    /**
+     * @return the cached FileTail, or nullptr if it is not cached
+     */
 	std::shared_ptr<FileTail> getFileTail(const std::string& id);
     void putRGFooter(const std::string& id, std::shared_ptr<RowGroupFooter> footer);
     bool containsRGFooter(const std::string& id);
+    /**
+     * @return the cached RowGroupFooter, or nullptr if it is not cached
+     */
 	std::shared_ptr<RowGroupFooter> getRGFooter(const std::string& id);
+    long getCachedBytes();
 private:
-    FileTailTable fileTailCacheMap;
-    RGFooterTable rowGroupFooterCacheMap;
-
+    struct Entry {
+        std::shared_ptr<google::protobuf::Message> value;
+        long bytes;
+        std::list<std::string>::iterator lruPosition;
+    };
+    struct Shard {
+        std::mutex lock;
+        // the most recently used id is at the front
+        std::list<std::string> lru;
+        std::unordered_map<std::string, Entry> entries;
+        long bytes = 0;
+    };
+    static const int SHARD_NUM = 16;
+    Shard & getShard(const std::string& key);
+    void put(const std::string& key, std::shared_ptr<google::protobuf::Message> value);
+    std::shared_ptr<google::protobuf::Message> get(const std::string& key);
+    long shardCapacity;
+    std::vector<Shard> shards;
 };
 #endif //PIXELS_PIXELSFOOTERCACHE_H
@@ -18,6 +18,24 @@ public:
     void close() override;
     long next() override;
 	bool hasNext() override;
+    /**
+     * Discard the buffered values and move the input stream to the given position,
+     * which must be the start of an encoded run, e.g., the start of a pixel.
+     * @param position the new read position in the input stream
+     */
+    void seek(int position);
+    /**
+     * Skip the next num values without returning them.
+     */
+    void skip(int num);
+    /**
+     * Get the next values of the current run without copying them.
+     * @param num the maximum number of values to get
+     * @param len set to the number of values returned, at most num
+     * @param repeating set to true if the values are all the same
+     * @return the values, which are valid until the next call to the decoder
+     */
+    const long * nextRun(int num, int & len, bool & repeating);
     ~RunLenIntDecoder();
 private:
 
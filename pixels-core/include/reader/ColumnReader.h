@@ -12,6 +12,7 @@
 #include "duckdb.h"
 #include "duckdb/common/types/vector.hpp"
 #include "PixelsFilter.h"
+#include "encoding/RunLenIntDecoder.h"
 
 class ColumnReader {
 public:
@@ -44,9 +45,75 @@ public:
                       pixels::proto::ColumnChunkIndex & chunkIndex,
                       std::shared_ptr<PixelsBitMask> filterMask);
 
-    void setValid(const std::shared_ptr<ByteBuffer>& input, int pixelStride, const std::shared_ptr<ColumnVector>& columnVector, int pixelId, bool hasNull);
+    /**
+     * Skip values without decoding them. The values may span pixels, and the
+     * readers are left at the value following them, so that the next read()
+     * continues from there.
+     *
+     * @param input    input buffer
+     * @param encoding encoding type
+     * @param offset   starting offset of values to skip
+     * @param size     number of values to skip
+     * @param pixelStride the stride (number of rows) in a pixels.
+     * @param chunkIndex the metadata of the column chunk to read.
+     */
+    virtual void skip(std::shared_ptr<ByteBuffer> input,
+                      pixels::proto::ColumnEncoding & encoding,
+                      int offset, int size, int pixelStride,
+                      pixels::proto::ColumnChunkIndex & chunkIndex);
+
+    /**
+     * Set the validity of the next size values into the vector from vectorIndex.
+     * The values may span pixels, the isNull bitmaps of the pixels are merged.
+     * It moves isNullOffset over the pixels it finishes, but not elementIndex.
+     */
+    void setValid(const std::shared_ptr<ByteBuffer>& input, int pixelStride,
+                  const std::shared_ptr<ColumnVector>& columnVector, int vectorIndex, int size,
+                  pixels::proto::ColumnChunkIndex & chunkIndex);
 
 protected:
+    /**
+     * Move isNullOffset and elementIndex over size skipped values.
+     */
+    void skipValid(int size, int pixelStride, pixels::proto::ColumnChunkIndex & chunkIndex);
+    /**
+     * Move the run-length decoder over the next size values. The whole pixels
+     * among them are skipped by skipEncodedPixel, the others are decoded and dropped.
+     */
+    void skipEncoded(const std::shared_ptr<RunLenIntDecoder>& decoder, int size, int pixelStride,
+                     pixels::proto::ColumnChunkIndex & chunkIndex);
+    /**
+     * Decode the next size run-length encoded values into values from vectorIndex.
+     * The repeating runs are filled at once, and the pixels whose statistics show a
+     * single value without nulls are filled without being decoded. The blocks of the
+     * vector covered by such values are marked as repeating.
+     */
+    template <class T>
+    void readRunLength(const std::shared_ptr<RunLenIntDecoder>& decoder, T * values, int size, int pixelStride,
+                       int vectorIndex, const std::shared_ptr<ColumnVector>& vector,
+                       pixels::proto::ColumnChunkIndex & chunkIndex,
+                       const std::shared_ptr<PixelsBitMask>& filterMask);
+    /**
+     * @return true if the statistic shows that all the values are value and none is null
+     */
+    bool getSingleValue(const pixels::proto::ColumnStatistic & statistic, long & value);
+    /**
+     * Mark the blocks of the vector inside [start, end) as repeating if they have no null.
+     * The elements from start to end are the same, and batchEnd is the end of the batch.
+     */
+    static void markRepeating(const std::shared_ptr<ColumnVector>& vector, int start, int end, int batchEnd);
+    /**
+     * @return the number of consecutive values from start that are filtered out by the mask
+     */
+    static int countFilteredOut(const std::shared_ptr<PixelsBitMask>& filterMask, int start, int end);
+    /**
+     * Move the run-length decoder over a skipped pixel. As each pixel is encoded
+     * independently, the decoder seeks to the start of the next pixel given by
+     * pixelPositions, and only decodes the values if the positions are absent.
+     */
+    static void skipEncodedPixel(const std::shared_ptr<RunLenIntDecoder>& decoder, int pixelId, int size,
+                                 pixels::proto::ColumnChunkIndex & chunkIndex);
+
     int elementIndex;
 	std::shared_ptr<TypeDescription> type;
     uint32_t isNullOffset;
@@ -18,6 +18,10 @@ public:
 	          int vectorIndex, std::shared_ptr<ColumnVector> vector,
 	          pixels::proto::ColumnChunkIndex & chunkIndex,
 			  std::shared_ptr<PixelsBitMask> filterMask) override;
+    void skip(std::shared_ptr<ByteBuffer> input,
+              pixels::proto::ColumnEncoding & encoding,
+              int offset, int size, int pixelStride,
+              pixels::proto::ColumnChunkIndex & chunkIndex) override;
 private:
 	/**
      * True if the data type of the values is long (int64), otherwise the data type is int32.
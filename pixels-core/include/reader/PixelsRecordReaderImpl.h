@@ -12,6 +12,7 @@
 #include "physical/SchedulerFactory.h"
 #include "pixels-common/pixels.pb.h"
 #include "PixelsFooterCache.h"
+#include "PixelsChunkCache.h"
 #include "reader/PixelsReaderOption.h"
 #include "utils/String.h"
 #include "TypeDescription.h"
@@ -46,6 +47,13 @@ public:
                                     std::shared_ptr<PixelsFooterCache> pixelsFooterCache
                                     );
     void asyncReadComplete(int requestSize);
+    /**
+     * Check or wait for the chunk of the given column of the current row group to be read.
+     * @param colId the column id of the chunk
+     * @param wait whether to wait for the chunk if its read is not completed yet
+     * @return true if the chunk is ready to be decoded
+     */
+    bool chunkReadComplete(uint32_t colId, bool wait);
     std::shared_ptr<VectorizedRowBatch> readBatch(bool reuse) override;
 	std::shared_ptr<TypeDescription> getResultSchema() override;
     bool read();
@@ -55,8 +63,15 @@ public:
 	void close() override;
 	uint32_t has_async_task_num_{0};
 private:
+    // the buffer pool slot that the chunks of this reader are read into, -1 before the first read
+    int bufferSlot;
     std::vector<int64_t> bufferIds;
     void prepareRead();
+    bool checkRowGroupStatistics(int rgId);
+    bool checkPixelStatistics(int pixelId);
+    void skipPixel();
+    void readColumn(int i, int curBatchSize, bool skip);
+    void forwardRows(int rowNum);
     void checkBeforeRead();
 	std::shared_ptr<VectorizedRowBatch> createEmptyEOFRowBatch(int size);
 	void UpdateRowGroupInfo();
@@ -77,6 +92,8 @@ private:
     int batchSize;
 	int curRowInStride;
     std::string fileName;
+    // the id of this file in the footer and chunk caches, empty if the file can not be cached
+    std::string fileCacheId;
 	bool endOfFile;
 	int curRGRowCount;
     bool enabledFilterPushDown;
@@ -97,6 +114,12 @@ private:
 
     // buffers of each chunk in this file, arranged by chunk's row group id and column id
     std::vector<std::shared_ptr<ByteBuffer>> chunkBuffers;
+    // the cached chunks of the current row group, which chunkBuffers have views of
+    std::vector<std::shared_ptr<ByteBuffer>> cachedChunks;
+    // the cache ids and column ids of the chunks to put into the chunk cache once they are read
+    std::vector<std::pair<std::string, uint32_t>> chunksToCache;
+    // the buffer id of the async read of each chunk, arranged by column id, -1 if the chunk is ready
+    std::vector<int64_t> pendingBufferIds;
     // column readers for each target columns
     std::vector<std::shared_ptr<ColumnReader>> readers;
     std::vector<uint32_t> targetColumns;
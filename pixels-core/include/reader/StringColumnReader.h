@@ -19,6 +19,10 @@ public:
               int vectorIndex, std::shared_ptr<ColumnVector> vector,
               pixels::proto::ColumnChunkIndex & chunkIndex,
 			  std::shared_ptr<PixelsBitMask> filterMask) override;
+    void skip(std::shared_ptr<ByteBuffer> input,
+              pixels::proto::ColumnEncoding & encoding,
+              int offset, int size, int pixelStride,
+              pixels::proto::ColumnChunkIndex & chunkIndex) override;
 
 private:
     /**
@@ -45,6 +49,12 @@ private:
 
 	int * dictStarts;
     int startsLength;
+    /**
+     * The dictionary of the chunk as a DuckDB vector, shared by the output vectors
+     * of dictionary-encoded values. It is built at the first read of the chunk.
+     */
+    std::shared_ptr<duckdb::Vector> dictionary;
+    void buildDictionary();
     /**
      * In this method, we have reduced most of significant memory copies.
      */
@@ -32,6 +32,19 @@ class BinaryColumnVector: public ColumnVector {
 public:
     duckdb::string_t * vector;
 
+    /**
+     * If the values are dictionary encoded and the vector is created for encoded
+     * values, vector is not set. Instead, the value of element i is the entry
+     * dictIds[i] of dictionary, and the null elements refer to the last entry of
+     * dictionary, which is null. This allows passing the values to DuckDB as a
+     * dictionary vector without resolving each of them.
+     */
+    bool dictionaryEncoded;
+    uint32_t * dictIds;
+    std::shared_ptr<duckdb::Vector> dictionary;
+    // the number of entries in dictionary, including the null entry
+    uint32_t dictionarySize;
+
     /**
     * Use this constructor by default. All column vectors
     * should normally be the default size.
@@ -49,6 +62,7 @@ public:
      */
     void setRef(int elementNum, uint8_t * const & sourceBuf, int start, int length);
     void * current() override;
+    uint32_t * currentDictIds();
     void close() override;
     void print(int rowCount) override;
 
@@ -20,7 +20,9 @@
 
 #include <iostream>
 #include <memory>
+#include <vector>
 #include "exception/InvalidArgumentException.h"
+#include "duckdb/common/vector_size.hpp"
 
 /**
  * ColumnVector derived from org.apache.hadoop.hive.ql.exec.vector.
@@ -42,6 +44,11 @@ public:
       * <b>DO NOT</b> modify it or used it as the number of values in-used.
       */
     uint64_t length;
+    /**
+      * the number of values allocated for this column vector, length may be
+      * resized to any value no larger than it.
+      */
+    uint64_t capacity;
     uint64_t writeIndex;
     uint64_t readIndex;
     uint64_t memoryUsage;
@@ -60,15 +67,24 @@ public:
 
     // DuckDB requires that the type of the valid mask should be uint64
     uint64_t * isValid;
+
+    /**
+     * repeating[i] is true if the elements of the i-th block of STANDARD_VECTOR_SIZE
+     * elements, i.e., the rows of an output chunk, are all non-null and the same.
+     * Such a block is passed on as a constant vector. It is set by the readers of
+     * run-length encoded values, and cleared by reset().
+     */
+    std::vector<bool> repeating;
     explicit ColumnVector(uint64_t len, bool encoding);
     void increment(uint64_t size);              // increment the readIndex
     bool isFull();                         // if the readIndex reaches length
     uint64_t position();                   // return readIndex
-    void resize(int size);                 // resize the column vector to a smaller one
+    void resize(int size);                 // resize the column vector within its capacity
     virtual void close();
     virtual void reset();
     virtual void * current() = 0;              // get the pointer in the current location
     uint64_t * currentValid();
+    bool isRepeating();                    // if the block starting at readIndex is repeating
     virtual void print(int rowCount);      // this is only used for debug
     bool checkValid(int index);
     void addNull();
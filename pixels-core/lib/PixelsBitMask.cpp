@@ -5,18 +5,26 @@
 #include "PixelsBitMask.h"
 #include <math.h>
 
+/**
+ * The mask is padded to whole 64-bit words plus one, so that a word starting
+ * at any bit of the mask can be loaded without checking the bounds.
+ */
+static long allocLength(long arrayLength) {
+    return (arrayLength + 7) / 8 * 8 + 8;
+}
+
 PixelsBitMask::PixelsBitMask(long length) {
     this->maskLength = length;
     this->arrayLength = std::ceil(1.0 * length / 8);
-    posix_memalign(reinterpret_cast<void **>(&mask), 4096, arrayLength);
-    memset(mask, 255, arrayLength);
+    posix_memalign(reinterpret_cast<void **>(&mask), 4096, allocLength(arrayLength));
+    memset(mask, 255, allocLength(arrayLength));
 }
 
 PixelsBitMask::PixelsBitMask(PixelsBitMask &other) {
     maskLength = other.maskLength;
     arrayLength = other.arrayLength;
-    posix_memalign(reinterpret_cast<void **>(&mask), 4096, arrayLength);
-    memcpy(mask, other.mask, arrayLength);
+    posix_memalign(reinterpret_cast<void **>(&mask), 4096, allocLength(arrayLength));
+    memcpy(mask, other.mask, allocLength(arrayLength));
 }
 
 PixelsBitMask::~PixelsBitMask() {
@@ -25,34 +33,40 @@ PixelsBitMask::~PixelsBitMask() {
 }
 
 bool PixelsBitMask::isNone() {
-    for(int i = 0; i < arrayLength - 1; i++) {
-        if(mask[i] != 0) {
+    for(long i = 0; i < maskLength; i += 64) {
+        if(getWord(i, (int) std::min(64L, maskLength - i)) != 0) {
             return false;
         }
     }
-    uint8_t lastByte = mask[arrayLength - 1];
-    uint8_t lastMask = (uint16_t)(1 << (maskLength - 8 * (arrayLength - 1))) - 1;
-    return !(lastByte & lastMask);
+    return true;
 }
 
 void PixelsBitMask::Or(PixelsBitMask &other) {
     // if their maskLength are the same, the arrayLength must be the same
     assert(other.maskLength == maskLength);
-    for(int i = 0; i < arrayLength; i++) {
-        mask[i] = mask[i] | other.mask[i];
+    auto * words = (uint64_t *) mask;
+    auto * otherWords = (uint64_t *) other.mask;
+    for(long i = 0; i < allocLength(arrayLength) / 8; i++) {
+        words[i] |= otherWords[i];
     }
 }
 
 void PixelsBitMask::And(PixelsBitMask &other) {
 // if their maskLength are the same, the arrayLength must be the same
     assert(other.maskLength == maskLength);
-    for(int i = 0; i < arrayLength; i++) {
-        mask[i] = mask[i] & other.mask[i];
+    auto * words = (uint64_t *) mask;
+    auto * otherWords = (uint64_t *) other.mask;
+    for(long i = 0; i < allocLength(arrayLength) / 8; i++) {
+        words[i] &= otherWords[i];
     }
 }
 
 void PixelsBitMask::set() {
-    memset(mask, 255, arrayLength);
+    memset(mask, 255, allocLength(arrayLength));
+}
+
+void PixelsBitMask::clear() {
+    memset(mask, 0, allocLength(arrayLength));
 }
 
 void PixelsBitMask::set(long index, uint8_t value) {
@@ -96,4 +110,61 @@ void PixelsBitMask::setByteAligned(long index, uint8_t value) {
     mask[index / 8] = value;
 }
 
+uint64_t PixelsBitMask::getWord(long index, int bits) {
+    long byteIndex = index / 8;
+    int shift = index % 8;
+    uint64_t word;
+    memcpy(&word, mask + byteIndex, sizeof(word));
+    if(shift != 0) {
+        word = (word >> shift) | ((uint64_t) mask[byteIndex + 8] << (64 - shift));
+    }
+    if(bits < 64) {
+        word &= (1ULL << bits) - 1;
+    }
+    return word;
+}
+
+long PixelsBitMask::count(long start, long length) {
+    assert(start + length <= maskLength);
+    long result = 0;
+    for(long i = 0; i < length; i += 64) {
+        result += __builtin_popcountll(getWord(start + i, (int) std::min(64L, length - i)));
+    }
+    return result;
+}
+
+bool PixelsBitMask::isAll(long start, long length) {
+    assert(start + length <= maskLength);
+    for(long i = 0; i < length; i += 64) {
+        int bits = (int) std::min(64L, length - i);
+        uint64_t all = bits == 64 ? ~0ULL : (1ULL << bits) - 1;
+        if(getWord(start + i, bits) != all) {
+            return false;
+        }
+    }
+    return true;
+}
 
+long PixelsBitMask::toSelection(long start, long length, uint32_t * sel) {
+    assert(start + length <= maskLength);
+    long selSize = 0;
+    for(long i = 0; i < length; i += 64) {
+        int bits = (int) std::min(64L, length - i);
+        uint64_t word = getWord(start + i, bits);
+        if(word == 0) {
+            continue;
+        }
+        if(bits == 64 && word == ~0ULL) {
+            for(int j = 0; j < 64; j++) {
+                sel[selSize++] = i + j;
+            }
+            continue;
+        }
+        // visit the set bits from the lowest one, clearing each after it is written
+        while(word != 0) {
+            sel[selSize++] = i + __builtin_ctzll(word);
+            word &= word - 1;
+        }
+    }
+    return selSize;
+}
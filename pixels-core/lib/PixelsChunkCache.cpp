@@ -0,0 +1,108 @@
+#include "PixelsChunkCache.h"
+#include "exception/InvalidArgumentException.h"
+#include "utils/ConfigFactory.h"
+#include <cstring>
+
+PixelsChunkCache::PixelsChunkCache()
+    : PixelsChunkCache(std::stol(ConfigFactory::Instance().getProperty("pixel.chunk.cache.size"))) {
+}
+
+PixelsChunkCache::PixelsChunkCache(long capacity) : shards(SHARD_NUM) {
+    if(capacity < 0) {
+        throw InvalidArgumentException("PixelsChunkCache: the capacity should not be negative. ");
+    }
+    shardCapacity = capacity / SHARD_NUM;
+}
+
+PixelsChunkCache & PixelsChunkCache::Instance() {
+    static PixelsChunkCache instance;
+    return instance;
+}
+
+std::string PixelsChunkCache::getCacheId(const std::string& fileCacheId, int rgId, uint32_t colId) {
+    return fileCacheId + "-" + std::to_string(rgId) + "-" + std::to_string(colId);
+}
+
+bool PixelsChunkCache::isEnabled() {
+    return shardCapacity > 0;
+}
+
+PixelsChunkCache::Shard & PixelsChunkCache::getShard(const std::string& key) {
+    return shards.at(std::hash<std::string>{}(key) % SHARD_NUM);
+}
+
+std::shared_ptr<ByteBuffer> PixelsChunkCache::get(const std::string& key, bool& admit) {
+    admit = false;
+    auto & shard = getShard(key);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    auto it = shard.entries.find(key);
+    if(it != shard.entries.end()) {
+        hitCount++;
+        shard.lru.splice(shard.lru.begin(), shard.lru, it->second.lruPosition);
+        return it->second.chunk;
+    }
+    missCount++;
+    auto ghost = shard.ghostPositions.find(key);
+    if(ghost != shard.ghostPositions.end()) {
+        // the second miss, the chunk is likely to be read again
+        shard.ghosts.erase(ghost->second);
+        shard.ghostPositions.erase(ghost);
+        admit = true;
+    } else {
+        shard.ghosts.push_front(key);
+        shard.ghostPositions[key] = shard.ghosts.begin();
+        if(shard.ghosts.size() > GHOST_NUM) {
+            shard.ghostPositions.erase(shard.ghosts.back());
+            shard.ghosts.pop_back();
+        }
+    }
+    return nullptr;
+}
+
+void PixelsChunkCache::put(const std::string& key, const std::shared_ptr<ByteBuffer>& chunk) {
+    long bytes = chunk->size();
+    if(bytes == 0 || bytes > shardCapacity) {
+        return;
+    }
+    // the chunk buffers of the buffer pool are reused by the next row groups, so the chunk
+    // is copied into an aligned buffer of its own, as the column readers expect
+    uint8_t * data = nullptr;
+    if(posix_memalign(reinterpret_cast<void **>(&data), 4096, bytes) != 0) {
+        return;
+    }
+    memcpy(data, chunk->getPointer(), bytes);
+    auto copy = std::make_shared<ByteBuffer>(data, (uint32_t) bytes, false);
+
+    auto & shard = getShard(key);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    if(shard.entries.find(key) != shard.entries.end()) {
+        // put by another reader in the meantime
+        return;
+    }
+    while(shard.bytes + bytes > shardCapacity) {
+        auto & victim = shard.entries.at(shard.lru.back());
+        shard.bytes -= (long) victim.chunk->size();
+        shard.entries.erase(shard.lru.back());
+        shard.lru.pop_back();
+    }
+    shard.lru.push_front(key);
+    shard.entries[key] = Entry{copy, shard.lru.begin()};
+    shard.bytes += bytes;
+}
+
+uint64_t PixelsChunkCache::getHitCount() {
+    return hitCount;
+}
+
+uint64_t PixelsChunkCache::getMissCount() {
+    return missCount;
+}
+
+long PixelsChunkCache::getCachedBytes() {
+    long bytes = 0;
+    for(auto & shard : shards) {
+        std::lock_guard<std::mutex> guard(shard.lock);
+        bytes += shard.bytes;
+    }
+    return bytes;
+}
@@ -11,11 +11,14 @@ int PixelsFilter::CompareAvx2(void * data, T constant) {
     __m256i constants;
     __m256i mask;
     if constexpr(sizeof(T) == 4) {
-        vector = _mm256_load_si256((__m256i *)data);
+        vector = _mm256_loadu_si256((__m256i *)data);
         constants = _mm256_set1_epi32(constant);
         if constexpr(std::is_same<OP, duckdb::Equals>()) {
             mask = _mm256_cmpeq_epi32(vector, constants);
             return _mm256_movemask_ps((__m256)mask);
+        } else if constexpr(std::is_same<OP, duckdb::NotEquals>()) {
+            mask = _mm256_cmpeq_epi32(vector, constants);
+            return ~_mm256_movemask_ps((__m256)mask);
         } else if constexpr(std::is_same<OP, duckdb::LessThan>()) {
             mask = _mm256_cmpgt_epi32(constants, vector);
             return _mm256_movemask_ps((__m256)mask);
@@ -31,8 +34,8 @@ int PixelsFilter::CompareAvx2(void * data, T constant) {
         }
     } else if constexpr(sizeof(T) == 8) {
         constants = _mm256_set1_epi64x(constant);
-        vector = _mm256_load_si256((__m256i *)data);
-        vector_next = _mm256_load_si256((__m256i *)((uint8_t *)data + 32));
+        vector = _mm256_loadu_si256((__m256i *)data);
+        vector_next = _mm256_loadu_si256((__m256i *)((uint8_t *)data + 32));
         int result = 0;
         if constexpr(std::is_same<OP, duckdb::Equals>()) {
             mask = _mm256_cmpeq_epi64(vector, constants);
@@ -40,6 +43,12 @@ int PixelsFilter::CompareAvx2(void * data, T constant) {
             mask = _mm256_cmpeq_epi64(vector_next, constants);
             result += _mm256_movemask_pd((__m256d)mask) << 4;
             return result;
+        } else if constexpr(std::is_same<OP, duckdb::NotEquals>()) {
+            mask = _mm256_cmpeq_epi64(vector, constants);
+            result = _mm256_movemask_pd((__m256d)mask);
+            mask = _mm256_cmpeq_epi64(vector_next, constants);
+            result += _mm256_movemask_pd((__m256d)mask) << 4;
+            return ~result;
         } else if constexpr(std::is_same<OP, duckdb::LessThan>()) {
             mask = _mm256_cmpgt_epi64(constants, vector);
             result = _mm256_movemask_pd((__m256d)mask);
@@ -138,15 +147,50 @@ void PixelsFilter::TemplatedFilterOperation(std::shared_ptr<ColumnVector> vector
             }
             break;
         }
+        case TypeDescription::TIMESTAMP: {
+            auto timestampColumnVector = std::static_pointer_cast<TimestampColumnVector>(vector);
+            int i = 0;
+#ifdef ENABLE_SIMD_FILTER
+            for (; i < vector->length - vector->length % 8; i += 8) {
+                uint8_t mask = CompareAvx2<T, OP>(timestampColumnVector->times + i, constant_value);
+                filter_mask.setByteAligned(i, mask);
+            }
+#endif
+            for (; i < vector->length; i++) {
+                filter_mask.set(i, OP::Operation((T)timestampColumnVector->times[i],
+                                                 constant_value));
+            }
+            break;
+        }
         case TypeDescription::STRING:
         case TypeDescription::BINARY:
         case TypeDescription::VARBINARY:
         case TypeDescription::CHAR:
         case TypeDescription::VARCHAR: {
             auto binaryColumnVector = std::static_pointer_cast<BinaryColumnVector>(vector);
+            if (binaryColumnVector->dictionaryEncoded) {
+                // compare each dictionary entry once, and look the results up by the dictionary ids
+                auto dictValues = duckdb::FlatVector::GetData<duckdb::string_t>(*binaryColumnVector->dictionary);
+                std::vector<bool> dictResults(binaryColumnVector->dictionarySize);
+                for (uint32_t j = 0; j < binaryColumnVector->dictionarySize; j++) {
+                    dictResults[j] = OP::Operation(dictValues[j], (duckdb::string_t)constant_value);
+                }
+                for (int i = 0; i < vector->length; i++) {
+                    if (filter_mask.get(i) && vector->checkValid(i)) {
+                        filter_mask.set(i, dictResults[binaryColumnVector->dictIds[i]]);
+                    } else {
+                        filter_mask.set(i, 0);
+                    }
+                }
+                break;
+            }
             for (int i = 0; i < vector->length; i++) {
-                filter_mask.set(i, OP::Operation((duckdb::string_t)binaryColumnVector->vector[i],
-                                                                 (duckdb::string_t)constant_value));
+                if (filter_mask.get(i) && vector->checkValid(i)) {
+                    filter_mask.set(i, OP::Operation((duckdb::string_t)binaryColumnVector->vector[i],
+                                                     (duckdb::string_t)constant_value));
+                } else {
+                    filter_mask.set(i, 0);
+                }
             }
             break;
         }
@@ -167,11 +211,18 @@ void PixelsFilter::FilterOperationSwitch(std::shared_ptr<ColumnVector> vector, d
             TemplatedFilterOperation<int32_t, OP>(vector, constant, filter_mask, type);
             break;
         case TypeDescription::LONG:
+        case TypeDescription::TIMESTAMP:
             TemplatedFilterOperation<int64_t, OP>(vector, constant, filter_mask, type);
             break;
-        case TypeDescription::DECIMAL:
-            TemplatedFilterOperation<int64_t, OP>(vector, constant, filter_mask, type);
+        case TypeDescription::DECIMAL: {
+            // short decimals are stored as unscaled int64 values, whatever the physical type of the constant
+            int64_t unscaled;
+            if (!GetUnscaledDecimal(constant, unscaled)) {
+                throw InvalidArgumentException("Unsupported decimal constant for filter. ");
+            }
+            TemplatedFilterOperation<int64_t, OP>(vector, duckdb::Value::BIGINT(unscaled), filter_mask, type);
             break;
+        }
         case TypeDescription::STRING:
         case TypeDescription::BINARY:
         case TypeDescription::VARBINARY:
@@ -184,6 +235,29 @@ void PixelsFilter::FilterOperationSwitch(std::shared_ptr<ColumnVector> vector, d
     }
 }
 
+bool PixelsFilter::GetUnscaledDecimal(const duckdb::Value &constant, int64_t &unscaled) {
+    switch (constant.type().InternalType()) {
+        case duckdb::PhysicalType::INT16:
+            unscaled = constant.GetValueUnsafe<int16_t>();
+            return true;
+        case duckdb::PhysicalType::INT32:
+            unscaled = constant.GetValueUnsafe<int32_t>();
+            return true;
+        case duckdb::PhysicalType::INT64:
+            unscaled = constant.GetValueUnsafe<int64_t>();
+            return true;
+        default:
+            return false;
+    }
+}
+
+void PixelsFilter::ApplyValidity(std::shared_ptr<ColumnVector> vector, PixelsBitMask &filterMask, bool isNull) {
+    auto *valid = (uint8_t *) vector->isValid;
+    for (long i = 0; i < filterMask.arrayLength; i++) {
+        filterMask.mask[i] &= isNull ? ~valid[i] : valid[i];
+    }
+}
+
 void PixelsFilter::ApplyFilter(std::shared_ptr<ColumnVector> vector, duckdb::TableFilter &filter,
                                PixelsBitMask& filterMask,
                                std::shared_ptr<TypeDescription> type) {
@@ -199,7 +273,9 @@ void PixelsFilter::ApplyFilter(std::shared_ptr<ColumnVector> vector, duckdb::Tab
         }
         case duckdb::TableFilterType::CONJUNCTION_OR: {
             auto &conjunction = (duckdb::ConjunctionOrFilter &)filter;
+            // the mask starts with all bits set, so it is cleared before the children are merged into it
             PixelsBitMask orMask(filterMask.maskLength);
+            orMask.clear();
             for (auto &childFilter : conjunction.child_filters) {
                 PixelsBitMask childMask(filterMask);
                 ApplyFilter(vector, *childFilter, childMask, type);
@@ -210,44 +286,170 @@ void PixelsFilter::ApplyFilter(std::shared_ptr<ColumnVector> vector, duckdb::Tab
         }
         case duckdb::TableFilterType::CONSTANT_COMPARISON: {
             auto &constant_filter = (duckdb::ConstantFilter &)filter;
+            // The comparison overwrites every bit of the mask it works on, so compare into a copy
+            // and merge it. The rows already filtered out and the null rows are not materialized by
+            // the readers: a string_t there is uninitialized memory, whose pointer must not be read,
+            // so the string comparison only looks at the rows still set in the copy and valid.
+            PixelsBitMask constantMask(filterMask);
             switch (constant_filter.comparison_type) {
                 case duckdb::ExpressionType::COMPARE_EQUAL:
                     FilterOperationSwitch<duckdb::Equals>(
-                            vector, constant_filter.constant, filterMask, type);
+                            vector, constant_filter.constant, constantMask, type);
+                    break;
+                case duckdb::ExpressionType::COMPARE_NOTEQUAL:
+                    FilterOperationSwitch<duckdb::NotEquals>(
+                            vector, constant_filter.constant, constantMask, type);
                     break;
                 case duckdb::ExpressionType::COMPARE_LESSTHAN:
                     FilterOperationSwitch<duckdb::LessThan>(
-                            vector, constant_filter.constant, filterMask, type);
+                            vector, constant_filter.constant, constantMask, type);
                     break;
                 case duckdb::ExpressionType::COMPARE_LESSTHANOREQUALTO:
                     FilterOperationSwitch<duckdb::LessThanEquals>(
-                            vector, constant_filter.constant, filterMask, type);
+                            vector, constant_filter.constant, constantMask, type);
                     break;
                 case duckdb::ExpressionType::COMPARE_GREATERTHAN:
                     FilterOperationSwitch<duckdb::GreaterThan>(
-                            vector, constant_filter.constant, filterMask, type);
+                            vector, constant_filter.constant, constantMask, type);
                     break;
                 case duckdb::ExpressionType::COMPARE_GREATERTHANOREQUALTO:
                     FilterOperationSwitch<duckdb::GreaterThanEquals>(
-                            vector, constant_filter.constant, filterMask, type);
+                            vector, constant_filter.constant, constantMask, type);
                     break;
                 default:
-                    D_ASSERT(0);
+                    throw InvalidArgumentException("Unsupported comparison type for filter. ");
             }
+            // a comparison with a null value is never true
+            ApplyValidity(vector, constantMask, false);
+            filterMask.And(constantMask);
             break;
         }
         case duckdb::TableFilterType::IS_NOT_NULL:
-            // TODO: support is null
+            ApplyValidity(vector, filterMask, false);
             break;
         case duckdb::TableFilterType::IS_NULL:
-            // TODO: support is null
+            ApplyValidity(vector, filterMask, true);
             break;
         default:
-            D_ASSERT(0);
-            break;
+            // the filter has been removed from the plan, so silently ignoring it would return wrong rows
+            throw InvalidArgumentException("Unsupported table filter type: " +
+                                           std::to_string((int) filter.filter_type));
     }
 }
 
+template <class T>
+bool PixelsFilter::CheckRange(duckdb::ExpressionType comparisonType, T min, T max, T constant) {
+    switch (comparisonType) {
+        case duckdb::ExpressionType::COMPARE_EQUAL:
+            return min <= constant && constant <= max;
+        case duckdb::ExpressionType::COMPARE_NOTEQUAL:
+            return !(min == constant && max == constant);
+        case duckdb::ExpressionType::COMPARE_LESSTHAN:
+            return min < constant;
+        case duckdb::ExpressionType::COMPARE_LESSTHANOREQUALTO:
+            return min <= constant;
+        case duckdb::ExpressionType::COMPARE_GREATERTHAN:
+            return max > constant;
+        case duckdb::ExpressionType::COMPARE_GREATERTHANOREQUALTO:
+            return max >= constant;
+        default:
+            return true;
+    }
+}
 
+bool PixelsFilter::CheckConstantStatistics(duckdb::ConstantFilter &filter,
+                                           const pixels::proto::ColumnStatistic &statistic,
+                                           std::shared_ptr<TypeDescription> type) {
+    auto &constant = filter.constant;
+    if (constant.IsNull()) {
+        return true;
+    }
+    switch (type->getCategory()) {
+        case TypeDescription::SHORT:
+        case TypeDescription::INT:
+        case TypeDescription::LONG: {
+            if (!statistic.has_intstatistics()) {
+                return true;
+            }
+            auto &intStat = statistic.intstatistics();
+            return CheckRange<int64_t>(filter.comparison_type, intStat.minimum(), intStat.maximum(),
+                                       constant.GetValue<int64_t>());
+        }
+        case TypeDescription::DECIMAL: {
+            // short decimals are stored (and recorded) as unscaled int64 values
+            if (!statistic.has_intstatistics()) {
+                return true;
+            }
+            int64_t unscaled;
+            if (!GetUnscaledDecimal(constant, unscaled)) {
+                return true;
+            }
+            auto &intStat = statistic.intstatistics();
+            return CheckRange<int64_t>(filter.comparison_type, intStat.minimum(), intStat.maximum(), unscaled);
+        }
+        case TypeDescription::DATE: {
+            if (!statistic.has_datestatistics()) {
+                return true;
+            }
+            auto &dateStat = statistic.datestatistics();
+            return CheckRange<int32_t>(filter.comparison_type, dateStat.minimum(), dateStat.maximum(),
+                                       constant.GetValueUnsafe<int32_t>());
+        }
+        case TypeDescription::TIMESTAMP: {
+            if (!statistic.has_timestampstatistics()) {
+                return true;
+            }
+            auto &tsStat = statistic.timestampstatistics();
+            return CheckRange<int64_t>(filter.comparison_type, tsStat.minimum(), tsStat.maximum(),
+                                       constant.GetValueUnsafe<int64_t>());
+        }
+        case TypeDescription::STRING:
+        case TypeDescription::CHAR:
+        case TypeDescription::VARCHAR: {
+            if (!statistic.has_stringstatistics()) {
+                return true;
+            }
+            auto &stringStat = statistic.stringstatistics();
+            if (!stringStat.has_minimum() || !stringStat.has_maximum()) {
+                return true;
+            }
+            return CheckRange<std::string>(filter.comparison_type, stringStat.minimum(), stringStat.maximum(),
+                                           duckdb::StringValue::Get(constant));
+        }
+        default:
+            return true;
+    }
+}
 
-
+bool PixelsFilter::CheckStatistics(duckdb::TableFilter &filter,
+                                   const pixels::proto::ColumnStatistic &statistic,
+                                   std::shared_ptr<TypeDescription> type) {
+    // numberOfValues is not reliably maintained by all writers, so we never infer
+    // an all-null chunk from it. Only min/max and hasNull are used for pruning.
+    switch (filter.filter_type) {
+        case duckdb::TableFilterType::CONJUNCTION_AND: {
+            auto &conjunction = (duckdb::ConjunctionAndFilter &)filter;
+            for (auto &childFilter : conjunction.child_filters) {
+                if (!CheckStatistics(*childFilter, statistic, type)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case duckdb::TableFilterType::CONJUNCTION_OR: {
+            auto &conjunction = (duckdb::ConjunctionOrFilter &)filter;
+            for (auto &childFilter : conjunction.child_filters) {
+                if (CheckStatistics(*childFilter, statistic, type)) {
+                    return true;
+                }
+            }
+            return conjunction.child_filters.empty();
+        }
+        case duckdb::TableFilterType::CONSTANT_COMPARISON:
+            return CheckConstantStatistics((duckdb::ConstantFilter &)filter, statistic, type);
+        case duckdb::TableFilterType::IS_NULL:
+            return !statistic.has_hasnull() || statistic.hasnull();
+        default:
+            return true;
+    }
+}
@@ -3,40 +3,106 @@
 //
 #include "PixelsFooterCache.h"
 #include "exception/InvalidArgumentException.h"
+#include "utils/ConfigFactory.h"
+#include <sys/stat.h>
 
-PixelsFooterCache::PixelsFooterCache() {
+PixelsFooterCache::PixelsFooterCache()
+    : PixelsFooterCache(std::stol(ConfigFactory::Instance().getProperty("pixel.footer.cache.size"))) {
 }
 
-void PixelsFooterCache::putFileTail(const std::string& id, std::shared_ptr<FileTail> fileTail) {
-    fileTailCacheMap[id] = fileTail;
+PixelsFooterCache::PixelsFooterCache(long capacity) : shards(SHARD_NUM) {
+    if(capacity < 0) {
+        throw InvalidArgumentException("PixelsFooterCache: the capacity should not be negative. ");
+    }
+    shardCapacity = capacity / SHARD_NUM;
 }
 
-std::shared_ptr<FileTail> PixelsFooterCache::getFileTail(const std::string& id) {
-    if(fileTailCacheMap.find(id) != fileTailCacheMap.end()) {
-        return fileTailCacheMap[id];
-    } else {
-        throw InvalidArgumentException("No such a FileTail id.");
+std::shared_ptr<PixelsFooterCache> PixelsFooterCache::Instance() {
+    static std::shared_ptr<PixelsFooterCache> instance = std::make_shared<PixelsFooterCache>();
+    return instance;
+}
+
+std::string PixelsFooterCache::getCacheId(const std::string& path) {
+    std::string localPath = path;
+    if(localPath.rfind("file://", 0) != std::string::npos) {
+        localPath.erase(0, 7);
+    }
+    struct stat fileStat{};
+    if(stat(localPath.c_str(), &fileStat) != 0) {
+        return "";
     }
+    return localPath + "@" + std::to_string(fileStat.st_mtim.tv_sec) + "." +
+           std::to_string(fileStat.st_mtim.tv_nsec) + "#" + std::to_string(fileStat.st_size);
 }
 
-void PixelsFooterCache::putRGFooter(const std::string& id, std::shared_ptr<RowGroupFooter> footer) {
-    rowGroupFooterCacheMap[id] = footer;
+PixelsFooterCache::Shard & PixelsFooterCache::getShard(const std::string& key) {
+    return shards.at(std::hash<std::string>{}(key) % SHARD_NUM);
+}
+
+void PixelsFooterCache::put(const std::string& key, std::shared_ptr<google::protobuf::Message> value) {
+    long bytes = (long) value->SpaceUsedLong() + (long) key.size();
+    if(bytes > shardCapacity) {
+        return;
+    }
+    auto & shard = getShard(key);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    auto it = shard.entries.find(key);
+    if(it != shard.entries.end()) {
+        shard.bytes -= it->second.bytes;
+        shard.lru.erase(it->second.lruPosition);
+        shard.entries.erase(it);
+    }
+    while(shard.bytes + bytes > shardCapacity) {
+        auto & victim = shard.entries.at(shard.lru.back());
+        shard.bytes -= victim.bytes;
+        shard.entries.erase(shard.lru.back());
+        shard.lru.pop_back();
+    }
+    shard.lru.push_front(key);
+    shard.entries[key] = Entry{std::move(value), bytes, shard.lru.begin()};
+    shard.bytes += bytes;
+}
+
+std::shared_ptr<google::protobuf::Message> PixelsFooterCache::get(const std::string& key) {
+    auto & shard = getShard(key);
+    std::lock_guard<std::mutex> guard(shard.lock);
+    auto it = shard.entries.find(key);
+    if(it == shard.entries.end()) {
+        return nullptr;
+    }
+    shard.lru.splice(shard.lru.begin(), shard.lru, it->second.lruPosition);
+    return it->second.value;
+}
+
+void PixelsFooterCache::putFileTail(const std::string& id, std::shared_ptr<FileTail> fileTail) {
+    put("tail:" + id, fileTail);
+}
+
+std::shared_ptr<FileTail> PixelsFooterCache::getFileTail(const std::string& id) {
+    return std::static_pointer_cast<FileTail>(get("tail:" + id));
 }
 
 bool PixelsFooterCache::containsFileTail(const std::string &id) {
-    return fileTailCacheMap.find(id) != fileTailCacheMap.end();
+    return getFileTail(id) != nullptr;
+}
+
+void PixelsFooterCache::putRGFooter(const std::string& id, std::shared_ptr<RowGroupFooter> footer) {
+    put("rg:" + id, footer);
 }
 
 std::shared_ptr<RowGroupFooter> PixelsFooterCache::getRGFooter(const std::string& id) {
-    if(rowGroupFooterCacheMap.find(id) != rowGroupFooterCacheMap.end()) {
-        return rowGroupFooterCacheMap[id];
-    } else {
-        throw InvalidArgumentException("No such a RGFooter id.");
-    }
+    return std::static_pointer_cast<RowGroupFooter>(get("rg:" + id));
 }
 
 bool PixelsFooterCache::containsRGFooter(const std::string &id) {
-    return rowGroupFooterCacheMap.find(id) != rowGroupFooterCacheMap.end();
+    return getRGFooter(id) != nullptr;
 }
 
-
+long PixelsFooterCache::getCachedBytes() {
+    long bytes = 0;
+    for(auto & shard : shards) {
+        std::lock_guard<std::mutex> guard(shard.lock);
+        bytes += shard.bytes;
+    }
+    return bytes;
+}
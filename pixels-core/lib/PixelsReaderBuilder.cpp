@@ -32,12 +32,16 @@ std::shared_ptr<PixelsReader> PixelsReaderBuilder::build() {
     // get PhysicalReader
     std::shared_ptr<PhysicalReader> fsReader =
 	    PhysicalReaderUtil::newPhysicalReader(builderStorage, builderPath);
-    // try to get file tail from cache
-    std::string fileName = fsReader->getName();
+    // try to get file tail from cache, the cache id changes if the file is rewritten
+    std::string cacheId;
     std::shared_ptr<pixels::proto::FileTail> fileTail;
-    if(builderPixelsFooterCache != nullptr && builderPixelsFooterCache->containsFileTail(fileName)) {
-        fileTail = builderPixelsFooterCache->getFileTail(fileName);
-    } else {
+    if(builderPixelsFooterCache != nullptr) {
+        cacheId = PixelsFooterCache::getCacheId(builderPath);
+        if(!cacheId.empty()) {
+            fileTail = builderPixelsFooterCache->getFileTail(cacheId);
+        }
+    }
+    if(fileTail == nullptr) {
         if(fsReader.get() == nullptr) {
             throw PixelsReaderException(
                     "Failed to create PixelsReader due to error of creating PhysicalReader");
@@ -63,8 +67,8 @@ std::shared_ptr<PixelsReader> PixelsReaderBuilder::build() {
                                     fileTailLength)) {
             throw InvalidArgumentException("PixelsReaderBuilder::build: paring FileTail error!");
         }
-		if(builderPixelsFooterCache != nullptr) {
-			builderPixelsFooterCache->putFileTail(fileName, fileTail);
+		if(builderPixelsFooterCache != nullptr && !cacheId.empty()) {
+			builderPixelsFooterCache->putFileTail(cacheId, fileTail);
 		}
     }
 
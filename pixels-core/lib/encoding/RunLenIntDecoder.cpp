@@ -35,6 +35,44 @@ long RunLenIntDecoder::next() {
     return result;
 }
 
+void RunLenIntDecoder::seek(int position) {
+    inputStream->setReadPos(position);
+    numLiterals = 0;
+    used = 0;
+}
+
+void RunLenIntDecoder::skip(int num) {
+    while(num > 0) {
+        if(used == numLiterals) {
+            numLiterals = 0;
+            used = 0;
+            readValues();
+            if(numLiterals == 0) {
+                break;
+            }
+        }
+        int skipped = std::min(num, numLiterals - used);
+        used += skipped;
+        num -= skipped;
+    }
+}
+
+const long * RunLenIntDecoder::nextRun(int num, int & len, bool & repeating) {
+    if(used == numLiterals) {
+        numLiterals = 0;
+        used = 0;
+        readValues();
+        if(numLiterals == 0) {
+            throw InvalidArgumentException("RunLenIntDecoder::nextRun: no more values in the input stream.");
+        }
+    }
+    len = std::min(num, numLiterals - used);
+    repeating = isRepeating;
+    const long * result = literals + used;
+    used += len;
+    return result;
+}
+
 void RunLenIntDecoder::readValues() {
 	// read the first 2 bits and determine the encoding type
 	isRepeating = false;
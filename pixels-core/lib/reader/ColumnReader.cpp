@@ -55,37 +55,237 @@ ColumnReader::read(std::shared_ptr<ByteBuffer> input, pixels::proto::ColumnEncod
                    pixels::proto::ColumnChunkIndex &chunkIndex, std::shared_ptr<PixelsBitMask> filterMask) {
 }
 
+void ColumnReader::skip(std::shared_ptr<ByteBuffer> input, pixels::proto::ColumnEncoding &encoding, int offset, int size,
+                        int pixelStride, pixels::proto::ColumnChunkIndex &chunkIndex) {
+    throw InvalidArgumentException("ColumnReader::skip is not supported by this column type. ");
+}
 
-void ColumnReader::setValid(const std::shared_ptr<ByteBuffer>& input, int pixelStride, const std::shared_ptr<ColumnVector>& columnVector, int pixelId, bool hasNull) {
-    int elementSizeInCurrPixels = std::min(pixelStride, (int)columnVector->length);
-    columnVector->isNull = input->getPointer() + isNullOffset;
+/**
+ * Copy size bits from src (starting at bit srcBit) to dst (starting at bit dstBit),
+ * inverted if invert is true. The bits are in little-endian order within each byte.
+ */
+static void copyBits(uint8_t * dst, int dstBit, const uint8_t * src, int srcBit, int size, bool invert) {
+    uint8_t flip = invert ? 0xFF : 0x00;
+    int i = 0;
+    if (dstBit % 8 == srcBit % 8) {
+        // the bits are aligned in the same way, so copy the leading bits until a byte
+        // boundary, and then whole bytes
+        for (; i < size && (dstBit + i) % 8 != 0; i++) {
+            int bit = (((src[(srcBit + i) / 8] ^ flip) >> ((srcBit + i) % 8)) & 1);
+            dst[(dstBit + i) / 8] = (dst[(dstBit + i) / 8] & ~(1 << ((dstBit + i) % 8))) | (bit << ((dstBit + i) % 8));
+        }
+        for (; i + 8 <= size; i += 8) {
+            dst[(dstBit + i) / 8] = src[(srcBit + i) / 8] ^ flip;
+        }
+    }
+    for (; i < size; i++) {
+        int bit = (((src[(srcBit + i) / 8] ^ flip) >> ((srcBit + i) % 8)) & 1);
+        dst[(dstBit + i) / 8] = (dst[(dstBit + i) / 8] & ~(1 << ((dstBit + i) % 8))) | (bit << ((dstBit + i) % 8));
+    }
+}
 
-    int byteSize = ceil(1.0 * elementSizeInCurrPixels / 8);
+/**
+ * Set size bits of dst starting at bit dstBit to 1.
+ */
+static void setBits(uint8_t * dst, int dstBit, int size) {
+    int i = 0;
+    for (; i < size && (dstBit + i) % 8 != 0; i++) {
+        dst[(dstBit + i) / 8] |= 1 << ((dstBit + i) % 8);
+    }
+    int bytes = (size - i) / 8;
+    memset(dst + (dstBit + i) / 8, 0xFF, bytes);
+    for (i += bytes * 8; i < size; i++) {
+        dst[(dstBit + i) / 8] |= 1 << ((dstBit + i) % 8);
+    }
+}
 
-    if (hasNull) {
-        for(int byteOffset = 0; byteOffset < byteSize; byteOffset++) {
-            ((uint8_t *) columnVector->isValid)[byteOffset] = ~(columnVector->isNull[byteOffset]);
+void ColumnReader::setValid(const std::shared_ptr<ByteBuffer>& input, int pixelStride,
+                            const std::shared_ptr<ColumnVector>& columnVector, int vectorIndex, int size,
+                            pixels::proto::ColumnChunkIndex & chunkIndex) {
+    auto * isValid = (uint8_t *) columnVector->isValid;
+    int done = 0;
+    while (done < size) {
+        int index = elementIndex + done;
+        int pixelId = index / pixelStride;
+        int indexInPixel = index % pixelStride;
+        int num = std::min(size - done, pixelStride - indexInPixel);
+        // each pixel has its own isNull bitmap starting at a byte boundary, if it has nulls
+        bool hasNull = chunkIndex.pixelstatistics(pixelId).statistic().hasnull();
+        if (hasNull) {
+            copyBits(isValid, vectorIndex + done, input->getPointer() + isNullOffset, indexInPixel, num, true);
+        } else {
+            setBits(isValid, vectorIndex + done, num);
         }
-        isNullOffset += byteSize;
-    } else {
-        memset(((uint8_t *)columnVector->isValid), 0xFF, byteSize);
+        if (hasNull && indexInPixel + num == pixelStride) {
+            isNullOffset += (pixelStride + 7) / 8;
+        }
+        done += num;
     }
-//    while (currentElementIndex < initElementIndex + columnVector->length) {
-//        int elementSizeInCurrPixels = std::min(pixelStride, (int)(initElementIndex + columnVector->length) - pixelId * pixelStride);
-//        elementSizeInCurrPixels = std::min(elementSizeInCurrPixels, pixelStride - (initElementIndex % pixelStride));
-//        int byteSize = ceil(1.0 * elementSizeInCurrPixels / 8);
-//        if (chunkIndex.pixelstatistics(pixelId).statistic().hasnull()) {
-//            for(int byteOffset = 0; byteOffset < byteSize; byteOffset++) {
-//                ((uint8_t *) columnVector->isValid)[byteOffset + (currentElementIndex - initElementIndex) / 8] =
-//                        ~(columnVector->isNull[byteOffset + nullId]);
-//            }
-//            nullId += elementSizeInCurrPixels / 8;
-//        } else {
-//            memset(((uint8_t *)columnVector->isValid) + (currentElementIndex - initElementIndex) / 8, 0xFF, byteSize);
-//        }
-//        currentElementIndex += elementSizeInCurrPixels;
-//        pixelId++;
-//    }
-//
-//    columnVector->isNull = (uint8_t *)(input->getPointer() + isNullOffset + pixelId * pixelStride / 8);
+}
+
+void ColumnReader::skipValid(int size, int pixelStride, pixels::proto::ColumnChunkIndex & chunkIndex) {
+    int end = elementIndex + size;
+    // only the bitmaps of the pixels that are passed over are skipped
+    for (int pixelId = elementIndex / pixelStride; (pixelId + 1) * pixelStride <= end; pixelId++) {
+        if (chunkIndex.pixelstatistics(pixelId).statistic().hasnull()) {
+            isNullOffset += (pixelStride + 7) / 8;
+        }
+    }
+    elementIndex = end;
+}
+
+void ColumnReader::skipEncoded(const std::shared_ptr<RunLenIntDecoder>& decoder, int size, int pixelStride,
+                               pixels::proto::ColumnChunkIndex &chunkIndex) {
+    int done = 0;
+    while (done < size) {
+        int index = elementIndex + done;
+        int pixelId = index / pixelStride;
+        int num = std::min(size - done, pixelStride - index % pixelStride);
+        if (index % pixelStride == 0 && num == pixelStride) {
+            skipEncodedPixel(decoder, pixelId, num, chunkIndex);
+        } else {
+            decoder->skip(num);
+        }
+        done += num;
+    }
+}
+
+void ColumnReader::skipEncodedPixel(const std::shared_ptr<RunLenIntDecoder>& decoder, int pixelId, int size,
+                                    pixels::proto::ColumnChunkIndex &chunkIndex) {
+    if (chunkIndex.pixelpositions_size() == 0) {
+        decoder->skip(size);
+    } else if (pixelId + 1 < chunkIndex.pixelpositions_size()) {
+        decoder->seek(chunkIndex.pixelpositions(pixelId + 1));
+    }
+    // otherwise, this is the last pixel of the chunk and nothing follows it
+}
+
+template <class T>
+void ColumnReader::readRunLength(const std::shared_ptr<RunLenIntDecoder>& decoder, T * values, int size,
+                                 int pixelStride, int vectorIndex, const std::shared_ptr<ColumnVector>& vector,
+                                 pixels::proto::ColumnChunkIndex & chunkIndex,
+                                 const std::shared_ptr<PixelsBitMask>& filterMask) {
+    // the current streak of repeating values, [streakStart, streakEnd) in the batch
+    int streakStart = 0;
+    int streakEnd = 0;
+    long streakValue = 0;
+    int i = 0;
+    while (i < size) {
+        // the values filtered out are skipped in the decoder without being materialized
+        if (filterMask != nullptr && !filterMask->get(i)) {
+            int skipped = countFilteredOut(filterMask, i, size);
+            skipEncoded(decoder, skipped, pixelStride, chunkIndex);
+            elementIndex += skipped;
+            i += skipped;
+            continue;
+        }
+        int len;
+        bool repeating;
+        long value;
+        const long * run = nullptr;
+        int pixelId = elementIndex / pixelStride;
+        if (elementIndex % pixelStride == 0 && pixelId < chunkIndex.pixelstatistics_size() &&
+            getSingleValue(chunkIndex.pixelstatistics(pixelId).statistic(), value)) {
+            len = std::min(pixelStride, size - i);
+            skipEncoded(decoder, len, pixelStride, chunkIndex);
+            repeating = true;
+        } else {
+            run = decoder->nextRun(size - i, len, repeating);
+            value = run[0];
+        }
+        if (repeating) {
+            std::fill(values + vectorIndex + i, values + vectorIndex + i + len, (T) value);
+            if (streakEnd == i && streakEnd > streakStart && streakValue == value) {
+                streakEnd += len;
+            } else {
+                markRepeating(vector, vectorIndex + streakStart, vectorIndex + streakEnd, vectorIndex + size);
+                streakStart = i;
+                streakEnd = i + len;
+                streakValue = value;
+            }
+        } else {
+            for (int j = 0; j < len; j++) {
+                values[vectorIndex + i + j] = (T) run[j];
+            }
+        }
+        elementIndex += len;
+        i += len;
+    }
+    markRepeating(vector, vectorIndex + streakStart, vectorIndex + streakEnd, vectorIndex + size);
+}
+
+template void ColumnReader::readRunLength<int>(const std::shared_ptr<RunLenIntDecoder>& decoder, int * values,
+        int size, int pixelStride, int vectorIndex, const std::shared_ptr<ColumnVector>& vector,
+        pixels::proto::ColumnChunkIndex & chunkIndex, const std::shared_ptr<PixelsBitMask>& filterMask);
+template void ColumnReader::readRunLength<long>(const std::shared_ptr<RunLenIntDecoder>& decoder, long * values,
+        int size, int pixelStride, int vectorIndex, const std::shared_ptr<ColumnVector>& vector,
+        pixels::proto::ColumnChunkIndex & chunkIndex, const std::shared_ptr<PixelsBitMask>& filterMask);
+
+bool ColumnReader::getSingleValue(const pixels::proto::ColumnStatistic & statistic, long & value) {
+    if (statistic.hasnull()) {
+        return false;
+    }
+    switch (type->getCategory()) {
+        case TypeDescription::SHORT:
+        case TypeDescription::INT:
+        case TypeDescription::LONG: {
+            auto & intStat = statistic.intstatistics();
+            if (!statistic.has_intstatistics() || !intStat.has_minimum() || !intStat.has_maximum() ||
+                intStat.minimum() != intStat.maximum()) {
+                return false;
+            }
+            value = intStat.minimum();
+            return true;
+        }
+        case TypeDescription::DATE: {
+            auto & dateStat = statistic.datestatistics();
+            if (!statistic.has_datestatistics() || !dateStat.has_minimum() || !dateStat.has_maximum() ||
+                dateStat.minimum() != dateStat.maximum()) {
+                return false;
+            }
+            value = dateStat.minimum();
+            return true;
+        }
+        case TypeDescription::TIMESTAMP: {
+            auto & tsStat = statistic.timestampstatistics();
+            if (!statistic.has_timestampstatistics() || !tsStat.has_minimum() || !tsStat.has_maximum() ||
+                tsStat.minimum() != tsStat.maximum()) {
+                return false;
+            }
+            value = tsStat.minimum();
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+void ColumnReader::markRepeating(const std::shared_ptr<ColumnVector>& vector, int start, int end, int batchEnd) {
+    for (int block = (start + STANDARD_VECTOR_SIZE - 1) / STANDARD_VECTOR_SIZE;
+         block * STANDARD_VECTOR_SIZE < end; block++) {
+        int blockStart = block * STANDARD_VECTOR_SIZE;
+        int blockEnd = std::min(blockStart + STANDARD_VECTOR_SIZE, batchEnd);
+        if (blockEnd > end) {
+            break;
+        }
+        // the block starts at a word of the validity mask
+        uint64_t * valid = vector->isValid + blockStart / 64;
+        int remaining = blockEnd - blockStart;
+        bool allValid = true;
+        for (; remaining >= 64 && allValid; remaining -= 64, valid++) {
+            allValid = *valid == ~0ULL;
+        }
+        if (allValid && remaining > 0) {
+            allValid = (*valid | (~0ULL << remaining)) == ~0ULL;
+        }
+        vector->repeating[block] = allValid;
+    }
+}
+
+int ColumnReader::countFilteredOut(const std::shared_ptr<PixelsBitMask>& filterMask, int start, int end) {
+    int count = 0;
+    while(start + count < end && !filterMask->get(start + count)) {
+        count++;
+    }
+    return count;
 }
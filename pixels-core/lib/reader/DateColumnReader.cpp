@@ -24,20 +24,30 @@ void DateColumnReader::read(std::shared_ptr<ByteBuffer> input, pixels::proto::Co
         isNullOffset = chunkIndex.isnulloffset();
 	}
 
-    int pixelId = elementIndex / pixelStride;
-    bool hasNull = chunkIndex.pixelstatistics(pixelId).statistic().hasnull();
-    setValid(input, pixelStride, vector, pixelId, hasNull);
+    setValid(input, pixelStride, vector, vectorIndex, size, chunkIndex);
 
 	if(encoding.kind() == pixels::proto::ColumnEncoding_Kind_RUNLENGTH) {
-        for (int i = 0; i < size; i++) {
-            if (elementIndex % pixelStride == 0) {
-                int pixelId = elementIndex / pixelStride;
-            }
-            columnVector->set(i + vectorIndex, (int) decoder->next());
-            elementIndex++;
-        }
+        readRunLength(decoder, columnVector->dates, size, pixelStride, vectorIndex,
+                      vector, chunkIndex, filterMask);
 	} else {
 		columnVector->dates = (int *)(input->getPointer() + input->getReadPos());
 		input->setReadPos(input->getReadPos() + size * sizeof(int));
+		elementIndex += size;
 	}
 }
+
+void DateColumnReader::skip(std::shared_ptr<ByteBuffer> input, pixels::proto::ColumnEncoding & encoding, int offset,
+                            int size, int pixelStride, pixels::proto::ColumnChunkIndex & chunkIndex) {
+	if(offset == 0) {
+		decoder = std::make_shared<RunLenIntDecoder>(input, true);
+		elementIndex = 0;
+		isNullOffset = chunkIndex.isnulloffset();
+	}
+
+	if(encoding.kind() == pixels::proto::ColumnEncoding_Kind_RUNLENGTH) {
+		skipEncoded(decoder, size, pixelStride, chunkIndex);
+	} else {
+		input->setReadPos(input->getReadPos() + size * sizeof(int));
+	}
+	skipValid(size, pixelStride, chunkIndex);
+}
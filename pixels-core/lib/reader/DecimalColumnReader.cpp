@@ -35,12 +35,14 @@ void DecimalColumnReader::read(std::shared_ptr<ByteBuffer> input, pixels::proto:
     }
     // TODO: we didn't implement the run length encoded method
 
-    int pixelId = elementIndex / pixelStride;
-    bool hasNull = chunkIndex.pixelstatistics(pixelId).statistic().hasnull();
-    setValid(input, pixelStride, vector, pixelId, hasNull);
+    setValid(input, pixelStride, vector, vectorIndex, size, chunkIndex);
     switch (columnVector->physical_type_) {
     case PhysicalType::INT16:
         for (int i = 0; i < size; i++) {
+            if (filterMask != nullptr && !filterMask->get(i)) {
+                input->setReadPos(input->getReadPos() + sizeof(int64_t));
+                continue;
+            }
             std::memcpy((uint8_t *)columnVector->vector +
                             (vectorIndex + i) * sizeof(int16_t),
                         input->getPointer() + input->getReadPos(),
@@ -50,6 +52,10 @@ void DecimalColumnReader::read(std::shared_ptr<ByteBuffer> input, pixels::proto:
         break;
     case PhysicalType::INT32:
         for (int i = 0; i < size; i++) {
+            if (filterMask != nullptr && !filterMask->get(i)) {
+                input->setReadPos(input->getReadPos() + sizeof(int64_t));
+                continue;
+            }
             std::memcpy((uint8_t *)columnVector->vector +
                             (vectorIndex + i) * sizeof(int32_t),
                         input->getPointer() + input->getReadPos(),
@@ -67,4 +73,17 @@ void DecimalColumnReader::read(std::shared_ptr<ByteBuffer> input, pixels::proto:
         throw std::runtime_error(
             "DecimalColumnReader: Unexpected Physical Type");
     }
+    elementIndex += size;
+}
+
+void DecimalColumnReader::skip(std::shared_ptr<ByteBuffer> input, pixels::proto::ColumnEncoding & encoding, int offset,
+                               int size, int pixelStride, pixels::proto::ColumnChunkIndex & chunkIndex) {
+    if(offset == 0) {
+        ColumnReader::elementIndex = 0;
+        isNullOffset = chunkIndex.isnulloffset();
+    }
+
+    // each value is stored as a long, whatever the physical type of the vector is
+    input->setReadPos(input->getReadPos() + size * sizeof(int64_t));
+    skipValid(size, pixelStride, chunkIndex);
 }
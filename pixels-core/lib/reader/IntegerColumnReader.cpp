@@ -24,9 +24,6 @@ void IntegerColumnReader::read(std::shared_ptr<ByteBuffer> input,
     std::shared_ptr<LongColumnVector> columnVector =
         std::static_pointer_cast<LongColumnVector>(vector);
 
-    // Make sure [offset, offset + size) is in the same pixels.
-    assert(offset / pixelStride == (offset + size - 1) / pixelStride);
-
     // if read from start, init the stream and decoder
     if (offset == 0) {
         decoder = std::make_shared<RunLenIntDecoder>(input, true);
@@ -35,20 +32,15 @@ void IntegerColumnReader::read(std::shared_ptr<ByteBuffer> input,
         isNullOffset = chunkIndex.isnulloffset();
     }
 
-    int pixelId = elementIndex / pixelStride;
-    // still need to add pixelsStatistics in the writer
-    bool hasNull = chunkIndex.pixelstatistics(pixelId).statistic().hasnull();
-    setValid(input, pixelStride, vector, pixelId, hasNull);
+    setValid(input, pixelStride, vector, vectorIndex, size, chunkIndex);
 
     if (encoding.kind() == pixels::proto::ColumnEncoding_Kind_RUNLENGTH) {
-        for (int i = 0; i < size; i++) {
-            if (isLong) {
-                columnVector->longVector[i + vectorIndex] = decoder->next();
-            } else {
-                *(reinterpret_cast<int *>(columnVector->intVector) + i +
-                  vectorIndex) = decoder->next();
-            }
-            elementIndex++;
+        if (isLong) {
+            readRunLength(decoder, columnVector->longVector, size, pixelStride, vectorIndex,
+                          vector, chunkIndex, filterMask);
+        } else {
+            readRunLength(decoder, reinterpret_cast<int *>(columnVector->intVector), size, pixelStride,
+                          vectorIndex, vector, chunkIndex, filterMask);
         }
     } else {
         if (isLong) {
@@ -57,12 +49,34 @@ void IntegerColumnReader::read(std::shared_ptr<ByteBuffer> input,
                         input->getPointer() + input->getReadPos(),
                         size * sizeof(int64_t));
             input->setReadPos(input->getReadPos() + size * sizeof(int64_t));
+            elementIndex += size;
         } else {
             // if int
             std::memcpy(
                 reinterpret_cast<int *>(columnVector->intVector) + vectorIndex,
                 input->getPointer() + input->getReadPos(), size * sizeof(int));
             input->setReadPos(input->getReadPos() + size * sizeof(int));
+            elementIndex += size;
         }
     }
 }
+
+void IntegerColumnReader::skip(std::shared_ptr<ByteBuffer> input,
+                               pixels::proto::ColumnEncoding &encoding,
+                               int offset, int size, int pixelStride,
+                               pixels::proto::ColumnChunkIndex &chunkIndex) {
+    if (offset == 0) {
+        decoder = std::make_shared<RunLenIntDecoder>(input, true);
+        ColumnReader::elementIndex = 0;
+        isLong = type->getCategory() == TypeDescription::Category::LONG;
+        isNullOffset = chunkIndex.isnulloffset();
+    }
+
+    if (encoding.kind() == pixels::proto::ColumnEncoding_Kind_RUNLENGTH) {
+        skipEncoded(decoder, size, pixelStride, chunkIndex);
+    } else {
+        int width = isLong ? sizeof(int64_t) : sizeof(int);
+        input->setReadPos(input->getReadPos() + size * width);
+    }
+    skipValid(size, pixelStride, chunkIndex);
+}
@@ -42,6 +42,7 @@ PixelsRecordReaderImpl::PixelsRecordReaderImpl(std::shared_ptr<PhysicalReader> r
     includedColumnNum = 0;
 	endOfFile = false;
     resultRowBatch = nullptr;
+    bufferSlot = -1;
     // ::DirectUringRandomAccessFile::Initialize();
     checkBeforeRead();
 }
@@ -147,33 +148,58 @@ void PixelsRecordReaderImpl::UpdateRowGroupInfo() {
 
 
 // If cross multiple row group, we only process one row group
-// In the current configuration, one batch is 10000 rows. This function creates
-// VectorizedRowBatch with some cols. Each column has 10000 elements. The columns
+// One batch has up to batchSize rows, which may span several pixels. This function creates
+// VectorizedRowBatch with some cols. Each column has batchSize elements. The columns
 // read value from chunkBuffer.
 std::shared_ptr<VectorizedRowBatch> PixelsRecordReaderImpl::readBatch(bool reuse) {
-    if(endOfFile) {
-		endOfFile = true;
-		return createEmptyEOFRowBatch(0);
-	}
-	if(!everRead) {
-		if(!read()) {
-			throw std::runtime_error("failed to read file");
-		}
-	}
+    while(true) {
+        if(endOfFile) {
+            return createEmptyEOFRowBatch(0);
+        }
+        if(!everRead) {
+            if(!read()) {
+                if(targetRGNum == 0) {
+                    return createEmptyEOFRowBatch(0);
+                }
+                throw std::runtime_error("failed to read file");
+            }
+        }
+        // the chunks are waited for by the columns decoding them, so that the
+        // columns whose chunks arrive first are decoded while the others are in flight
+        // skip the pixels in which no row can satisfy the filter, without decoding them
+        int pixelStride = postScript.pixelstride();
+        if(filter == nullptr || curRowInRG % pixelStride != 0 ||
+           checkPixelStatistics(curRowInRG / pixelStride)) {
+            break;
+        }
+        skipPixel();
+    }
 
 
 	// TODO: resultRowBatch.projectionSize
 
 
-    // update current batch size
+    // update current batch size. A batch may span pixels, but it stops before a pixel
+    // that can be skipped, so that the next batch skips it without decoding.
     int curBatchSize = std::min(curRGRowCount - curRowInRG, std::min(batchSize, curRGRowCount));
+    if(filter != nullptr) {
+        int pixelStride = postScript.pixelstride();
+        for(int pixelStart = (curRowInRG / pixelStride + 1) * pixelStride;
+            pixelStart < curRowInRG + curBatchSize; pixelStart += pixelStride) {
+            if(!checkPixelStatistics(pixelStart / pixelStride)) {
+                curBatchSize = pixelStart - curRowInRG;
+                break;
+            }
+        }
+    }
     if(resultRowBatch == nullptr) {
-        resultRowBatch = resultSchema->createRowBatch(curBatchSize, resultColumnsEncoded);
+        // allocate a whole batch even if this one is cut short, the following ones are resized within it
+        resultRowBatch = resultSchema->createRowBatch(std::min(batchSize, curRGRowCount), resultColumnsEncoded);
     } else {
         resultRowBatch->reset();
-        if(curBatchSize != resultRowBatch->maxSize) {
-            resultRowBatch->resize(curBatchSize);
-        }
+    }
+    if(curBatchSize != resultRowBatch->maxSize) {
+        resultRowBatch->resize(curBatchSize);
     }
 
     auto columnVectors = resultRowBatch->cols;
@@ -182,50 +208,105 @@ std::shared_ptr<VectorizedRowBatch> PixelsRecordReaderImpl::readBatch(bool reuse
     }
 
     std::vector<int> filterColumnIndex;
-    if(has_async_task_num_ > 0) {
-      asyncReadComplete(has_async_task_num_);
-    }
     if(filter != nullptr) {
         for (auto &filterCol : filter->filters) {
-            if(filterMask->isNone()) {
+            if(filterMask->count(0, curBatchSize) == 0) {
                 break;
             }
             int i = filterCol.first;
             int index = curChunkBufferIndex.at(i);
-            auto & encoding = curEncoding.at(i);
-            auto & chunkIndex = curChunkIndex.at(i);
-            readers.at(i)->read(chunkBuffers.at(index), *encoding, curRowInRG, curBatchSize,
-                                postScript.pixelstride(), resultRowBatch->rowCount,
-                                columnVectors.at(i), *chunkIndex, filterMask);
+            chunkReadComplete(index, true);
+            readColumn(i, curBatchSize, false);
             filterColumnIndex.emplace_back(index);
             PixelsFilter::ApplyFilter(columnVectors.at(i), *filterCol.second, *filterMask,
                                       resultSchema->getChildren().at(i));
         }
     }
 
-    // read vectors
+    // If no row of the batch survives the filter, the remaining columns are skipped
+    // without decoding. Otherwise, they only decode the values selected by the filter mask.
+    bool skipRemaining = filterMask != nullptr && filterMask->count(0, curBatchSize) == 0;
+
+    // read vectors. The columns whose chunks are already read go first, and
+    // the others are waited for in order afterwards.
+    std::vector<int> unreadColumns;
     for(int i = 0; i < resultColumns.size(); i++) {
-        // TODO: Refer to Issue #564. Disable data skipping
-        //if(filterMask != nullptr) {
-        //    if(filterMask->isNone()) {
-        //        break;
-        //    }
-        //}
         // Skip the columns that calculate the filter mask, since they are already processed
         int index = curChunkBufferIndex.at(i);
         if(std::find(filterColumnIndex.begin(), filterColumnIndex.end(), index) != filterColumnIndex.end()) {
             continue;
         }
+        if(!chunkReadComplete(index, false)) {
+            unreadColumns.emplace_back(i);
+            continue;
+        }
+        readColumn(i, curBatchSize, skipRemaining);
+    }
+    for(int i : unreadColumns) {
+        chunkReadComplete(curChunkBufferIndex.at(i), true);
+        readColumn(i, curBatchSize, skipRemaining);
+    }
+
+    resultRowBatch->rowCount += curBatchSize;
+    forwardRows(curBatchSize);
+	return resultRowBatch;
+}
+
+bool PixelsRecordReaderImpl::checkPixelStatistics(int pixelId) {
+    auto columnSchemas = resultSchema->getChildren();
+    for(auto &filterCol : filter->filters) {
+        int i = (int) filterCol.first;
+        auto & chunkIndex = curChunkIndex.at(i);
+        if(pixelId >= chunkIndex->pixelstatistics_size()) {
+            continue;
+        }
+        if(!PixelsFilter::CheckStatistics(*filterCol.second, chunkIndex->pixelstatistics(pixelId).statistic(),
+                                          columnSchemas.at(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Read curBatchSize rows of the i-th result column into the result row batch,
+ * or skip them if skip is true.
+ */
+void PixelsRecordReaderImpl::readColumn(int i, int curBatchSize, bool skip) {
+    int index = curChunkBufferIndex.at(i);
+    auto & encoding = curEncoding.at(i);
+    auto & chunkIndex = curChunkIndex.at(i);
+    if(skip) {
+        readers.at(i)->skip(chunkBuffers.at(index), *encoding, curRowInRG, curBatchSize,
+                            postScript.pixelstride(), *chunkIndex);
+        return;
+    }
+    readers.at(i)->read(chunkBuffers.at(index), *encoding, curRowInRG, curBatchSize,
+                        postScript.pixelstride(), resultRowBatch->rowCount,
+                        resultRowBatch->cols.at(i), *chunkIndex, filterMask);
+}
+
+/**
+ * Skip the pixel starting at curRowInRG in all the column readers, so that it
+ * produces no output rows.
+ */
+void PixelsRecordReaderImpl::skipPixel() {
+    int pixelStride = postScript.pixelstride();
+    int pixelSize = std::min(pixelStride, curRGRowCount - curRowInRG);
+    for(int i = 0; i < resultColumns.size(); i++) {
+        int index = curChunkBufferIndex.at(i);
         auto & encoding = curEncoding.at(i);
         auto & chunkIndex = curChunkIndex.at(i);
-        readers.at(i)->read(chunkBuffers.at(index), *encoding, curRowInRG, curBatchSize,
-                            postScript.pixelstride(), resultRowBatch->rowCount,
-                            columnVectors.at(i), *chunkIndex, filterMask);
+        chunkReadComplete(index, true);
+        readers.at(i)->skip(chunkBuffers.at(index), *encoding, curRowInRG, pixelSize,
+                            pixelStride, *chunkIndex);
     }
+    forwardRows(pixelSize);
+}
 
+void PixelsRecordReaderImpl::forwardRows(int rowNum) {
     // update current row index in the row group
-    curRowInRG += curBatchSize;
-    resultRowBatch->rowCount += curBatchSize;
+    curRowInRG += rowNum;
     // update row group index if current row index exceeds max row count in the row group
     if(curRowInRG >= curRGRowCount) {
         curRGIdx++;
@@ -238,7 +319,6 @@ std::shared_ptr<VectorizedRowBatch> PixelsRecordReaderImpl::readBatch(bool reuse
         }
         curRowInRG = 0;
     }
-	return resultRowBatch;
 }
 
 
@@ -250,8 +330,10 @@ void PixelsRecordReaderImpl::prepareRead() {
     uint64_t includedRowNum = 0;
     // read row group statistics and find target row groups
     for(int i = 0; i < RGLen; i++) {
-        includedRGs.at(i) = true;
-        includedRowNum += footer.rowgroupinfos(RGStart + i).numberofrows();
+        includedRGs.at(i) = checkRowGroupStatistics(RGStart + i);
+        if(includedRGs.at(i)) {
+            includedRowNum += footer.rowgroupinfos(RGStart + i).numberofrows();
+        }
     }
     targetRGs.clear();
     targetRGs.resize(RGLen);
@@ -264,13 +346,15 @@ void PixelsRecordReaderImpl::prepareRead() {
     }
     targetRGNum = targetRGIdx;
 
-    // TODO: if taregetRGNum == 0
+    // all row groups are pruned by the statistics, so no footer or chunk needs to be read
+    if(targetRGNum == 0) {
+        endOfFile = true;
+        return;
+    }
 
     // read row group footers
     rowGroupFooters.clear();
     rowGroupFooters.resize(targetRGNum);
-    std::vector<bool> rowGroupFooterCacheHit;
-    rowGroupFooterCacheHit.resize(targetRGNum);
 
     /**
      * Issue #114:
@@ -282,14 +366,19 @@ void PixelsRecordReaderImpl::prepareRead() {
     RequestBatch requestBatch;
     std::vector<int> fis;
     std::vector<std::string> rgCacheIds;
+    fileCacheId = PixelsFooterCache::getCacheId(physicalReader->getPath());
     for(int i = 0; i < targetRGNum; i++) {
         int rgId = targetRGs[i];
-        std::string rgCacheId = fileName + "-" + std::to_string(rgId);
+        std::string rgCacheId = footerCache == nullptr || fileCacheId.empty() ? "" :
+                                fileCacheId + "-" + std::to_string(rgId);
         rgCacheIds.emplace_back(rgCacheId);
-        if(footerCache != nullptr && footerCache->containsRGFooter(rgCacheId)) {
+        std::shared_ptr<pixels::proto::RowGroupFooter> cached;
+        if(!rgCacheId.empty()) {
+            cached = footerCache->getRGFooter(rgCacheId);
+        }
+        if(cached != nullptr) {
             // cache hit
-            rowGroupFooters.at(i) = footerCache->getRGFooter(rgCacheId);
-            rowGroupFooterCacheHit.at(i) = true;
+            rowGroupFooters.at(i) = cached;
         } else {
             // cache miss, read from disk and put it into cache
             const pixels::proto::RowGroupInformation& rowGroupInformation = footer.rowgroupinfos(rgId);
@@ -297,21 +386,19 @@ void PixelsRecordReaderImpl::prepareRead() {
             uint64_t footerLength = rowGroupInformation.footerlength();
             fis.push_back(i);
             requestBatch.add(queryId, (int) footerOffset, (int) footerLength);
-            rowGroupFooterCacheHit.at(i) = false;
         }
     }
     Scheduler * scheduler = SchedulerFactory::Instance()->getScheduler();
     auto bbs = scheduler->executeBatch(physicalReader, requestBatch, queryId);
     // TODO: the return value should be unique_ptr?
 
+    // the i-th buffer is the footer of the fis[i]-th target row group, which missed the cache
     for(int i = 0; i < bbs.size(); i++) {
-        if(!rowGroupFooterCacheHit.at(i)) {
-			auto parsed = std::make_shared<pixels::proto::RowGroupFooter>();
-            parsed->ParseFromArray(bbs[i]->getPointer(), (int)bbs[i]->size());
-            rowGroupFooters.at(fis[i]) = parsed;
-			if(footerCache != nullptr) {
-				footerCache->putRGFooter(rgCacheIds[fis[i]], parsed);
-			}
+        auto parsed = std::make_shared<pixels::proto::RowGroupFooter>();
+        parsed->ParseFromArray(bbs[i]->getPointer(), (int)bbs[i]->size());
+        rowGroupFooters.at(fis[i]) = parsed;
+        if(!rgCacheIds[fis[i]].empty()) {
+            footerCache->putRGFooter(rgCacheIds[fis[i]], parsed);
         }
     }
 
@@ -325,21 +412,67 @@ void PixelsRecordReaderImpl::prepareRead() {
 	UpdateRowGroupInfo();
 }
 
+/**
+ * Check the pushed-down filters against the statistics of a row group.
+ *
+ * @param rgId the id of the row group in this file
+ * @return false if the row group can not contain any row that satisfies the filters
+ */
+bool PixelsRecordReaderImpl::checkRowGroupStatistics(int rgId) {
+    if(filter == nullptr || rgId >= footer.rowgroupstats_size()) {
+        return true;
+    }
+    const pixels::proto::RowGroupStatistic& rgStat = footer.rowgroupstats(rgId);
+    auto columnSchemas = resultSchema->getChildren();
+    for(auto &filterCol : filter->filters) {
+        int i = (int) filterCol.first;
+        uint32_t colId = resultColumns.at(i);
+        if(colId >= rgStat.columnchunkstats_size()) {
+            continue;
+        }
+        if(!PixelsFilter::CheckStatistics(*filterCol.second, rgStat.columnchunkstats(colId),
+                                          columnSchemas.at(i))) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void PixelsRecordReaderImpl::asyncReadComplete(int requestSize) {
     if(ConfigFactory::Instance().boolCheckProperty("localfs.enable.async.io")
       && has_async_task_num_ >= requestSize) {
-        if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "iouring") {
-            auto localReader = std::static_pointer_cast<PhysicalLocalReader>(physicalReader);
-            localReader->readAsyncComplete(requestSize);
-          has_async_task_num_ -= requestSize;
-        } else if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "aio") {
-            throw InvalidArgumentException("PhysicalLocalReader::readAsync: We don't support aio for our async read yet.");
+        // io_uring and aio share the same submit and complete contract
+        auto localReader = std::static_pointer_cast<PhysicalLocalReader>(physicalReader);
+        localReader->readAsyncComplete(requestSize, bufferSlot);
+        has_async_task_num_ -= requestSize;
+        if(has_async_task_num_ == 0) {
+            std::fill(pendingBufferIds.begin(), pendingBufferIds.end(), -1);
         }
     }
 
 }
 
 
+bool PixelsRecordReaderImpl::chunkReadComplete(uint32_t colId, bool wait) {
+    if(colId < pendingBufferIds.size() && pendingBufferIds.at(colId) >= 0) {
+        auto localReader = std::static_pointer_cast<PhysicalLocalReader>(physicalReader);
+        if(!localReader->readAsyncComplete(pendingBufferIds.at(colId), wait)) {
+            return false;
+        }
+        pendingBufferIds.at(colId) = -1;
+        has_async_task_num_--;
+    }
+    // the admitted chunks are copied into the chunk cache once they are read
+    for(auto it = chunksToCache.begin(); it != chunksToCache.end(); it++) {
+        if(it->second == colId) {
+            PixelsChunkCache::Instance().put(it->first, chunkBuffers.at(colId));
+            chunksToCache.erase(it);
+            break;
+        }
+    }
+    return true;
+}
+
 std::shared_ptr<PixelsBitMask> PixelsRecordReaderImpl::getFilterMask() {
     return filterMask;
 }
@@ -348,6 +481,9 @@ bool PixelsRecordReaderImpl::read() {
 	if(!everPrepareRead) {
 		prepareRead();
 	}
+	if(targetRGNum == 0) {
+		return false;
+	}
 
     everRead = true;
 
@@ -356,12 +492,18 @@ bool PixelsRecordReaderImpl::read() {
     // TODO: this should remove later
     chunkBuffers.clear();
     chunkBuffers.resize(includedColumns.size());
+    cachedChunks.clear();
+    chunksToCache.clear();
+    pendingBufferIds.assign(includedColumns.size(), -1);
     std::vector<ChunkId> diskChunks;
     diskChunks.reserve(targetColumns.size());
+    // the index of each disk chunk among the target columns, which is its index in the buffer pool
+    std::vector<int> poolIndexes;
+    std::vector<uint32_t> colIds;
+    std::vector<uint64_t> bytes;
 
-
-    // TODO: support cache read
-
+    auto &chunkCache = PixelsChunkCache::Instance();
+    bool useChunkCache = chunkCache.isEnabled() && !fileCacheId.empty();
 	const pixels::proto::RowGroupIndex& rowGroupIndex =
 			rowGroupFooters[curRGIdx]->rowgroupindexentry();
 	for(int colId: targetColumns) {
@@ -369,35 +511,66 @@ bool PixelsRecordReaderImpl::read() {
 				rowGroupIndex.columnchunkindexentries(colId);
         if (!chunkIndex.littleendian()) {
             throw InvalidArgumentException("Pixels C++ reader only supports little endianness. ");
+        }
+        colIds.emplace_back(colId);
+        bytes.emplace_back(chunkIndex.chunklength());
+        if(useChunkCache && chunkIndex.chunklength() > 0) {
+            bool admit;
+            std::string chunkCacheId = PixelsChunkCache::getCacheId(fileCacheId, targetRGs.at(curRGIdx), colId);
+            auto cached = chunkCache.get(chunkCacheId, admit);
+            if(cached != nullptr) {
+                // the cached chunk is kept alive while the column readers read their own view of it
+                cachedChunks.emplace_back(cached);
+                chunkBuffers.at(colId) = std::make_shared<ByteBuffer>(*cached, 0, cached->size());
+                continue;
+            }
+            if(admit) {
+                chunksToCache.emplace_back(chunkCacheId, colId);
+            }
         }
 		ChunkId chunk(curRGIdx, colId, chunkIndex.chunkoffset(), chunkIndex.chunklength());
 		diskChunks.emplace_back(chunk);
+        poolIndexes.emplace_back((int) colIds.size() - 1);
 	}
 
+    // the chunks of a mapped file are views into the mapping, so they don't need the buffer pool
+    bool useBufferPool = !ConfigFactory::Instance().boolCheckProperty("localfs.enable.mmap");
+    if(useBufferPool && !colIds.empty()) {
+        // the buffer pool is initialized with all target columns even if some of them are cached,
+        // so that the pool layout is the same for all row groups
+		::BufferPool::Initialize(colIds, bytes, fileSchema->getFieldNames());
+        if(ConfigFactory::Instance().getProperty("localfs.async.lib") == "iouring") {
+            ::DirectUringRandomAccessFile::RegisterBufferFromPool(colIds);
+        }
+        // the first read takes the current slot of the buffer pool, and the following
+        // row groups of this reader are read into the same slot
+        if(bufferSlot < 0) {
+            bufferSlot = ::BufferPool::GetBufferSlot();
+        }
+    }
 
     if(!diskChunks.empty()) {
         RequestBatch requestBatch((int)diskChunks.size());
         Scheduler * scheduler = SchedulerFactory::Instance()->getScheduler();
-		std::vector<uint32_t> colIds;
-		std::vector<uint64_t> bytes;
         for(int i = 0; i < diskChunks.size(); i++) {
             ChunkId chunk = diskChunks.at(i);
-            requestBatch.add(queryId, chunk.offset, (int)chunk.length, ::BufferPool::GetBufferId(i));
-			colIds.emplace_back(chunk.columnId);
-			bytes.emplace_back(chunk.length);
+            requestBatch.add(queryId, chunk.offset, (int)chunk.length,
+                             useBufferPool ? ::BufferPool::GetBufferId(poolIndexes.at(i), bufferSlot) : -1);
         }
-		::BufferPool::Initialize(colIds, bytes, fileSchema->getFieldNames());
-        ::DirectUringRandomAccessFile::RegisterBufferFromPool(colIds);
 		std::vector<std::shared_ptr<ByteBuffer>> originalByteBuffers;
-		for(int i = 0; i < colIds.size(); i++) {
-            auto colId = colIds.at(i);
-			originalByteBuffers.emplace_back(::BufferPool::GetBuffer(colId));
+		for(int i = 0; useBufferPool && i < diskChunks.size(); i++) {
+            auto colId = diskChunks.at(i).columnId;
+			originalByteBuffers.emplace_back(::BufferPool::GetBuffer(colId, bufferSlot));
 		}
 
 		auto byteBuffers = scheduler->executeBatch(physicalReader, requestBatch, originalByteBuffers, queryId);
 
       if(ConfigFactory::Instance().boolCheckProperty("localfs.enable.async.io") && originalByteBuffers.size() > 0) {
         has_async_task_num_ += diskChunks.size();
+        auto requests = requestBatch.getRequests();
+        for(int i = 0; i < diskChunks.size(); i++) {
+            pendingBufferIds.at(diskChunks.at(i).columnId) = requests.at(i).bufferId;
+        }
       }
         for(int index = 0; index < diskChunks.size(); index++) {
             ChunkId chunk = diskChunks.at(index);
@@ -438,6 +611,11 @@ bool PixelsRecordReaderImpl::isEndOfFile() {
 }
 
 void PixelsRecordReaderImpl::close() {
+	// the reads still in flight must complete before their buffers are reused by other readers
+	for(uint32_t colId = 0; colId < pendingBufferIds.size(); colId++) {
+		chunkReadComplete(colId, true);
+	}
+	pendingBufferIds.clear();
 	// release chunk buffers
 	chunkBuffers.clear();
 	for(const auto& reader: readers) {
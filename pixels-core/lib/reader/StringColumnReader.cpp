@@ -38,9 +38,8 @@ void StringColumnReader::read(std::shared_ptr<ByteBuffer> input, pixels::proto::
         readContent(input, input->bytesRemaining(), encoding);
     }
 
-    int pixelId = elementIndex / pixelStride;
-    bool hasNull = chunkIndex.pixelstatistics(pixelId).statistic().hasnull();
-    setValid(input, pixelStride, vector, pixelId, hasNull);
+    setValid(input, pixelStride, vector, vectorIndex, size, chunkIndex);
+    columnVector->dictionaryEncoded = false;
 
     // TODO: if dictionary encoded
     if (encoding.kind() == pixels::proto::ColumnEncoding_Kind_DICTIONARY) {
@@ -49,13 +48,31 @@ void StringColumnReader::read(std::shared_ptr<ByteBuffer> input, pixels::proto::
             cascadeRLE = true;
         }
 
+        if (columnVector->encoding) {
+            // keep the dictionary ids instead of resolving them, the dictionary is built once per chunk
+            if (dictionary == nullptr) {
+                buildDictionary();
+            }
+            columnVector->dictionaryEncoded = true;
+            columnVector->dictionary = dictionary;
+            columnVector->dictionarySize = startsLength;
+            auto nullId = (uint32_t) (startsLength - 1);
+            for(int i = 0; i < size; i++) {
+                // each element consumes one dictionary id, whether it is null or not
+                auto originId = (uint32_t) (cascadeRLE ? contentDecoder->next() : contentBuf->getInt());
+                columnVector->dictIds[i + vectorIndex] = vector->checkValid(i + vectorIndex) ? originId : nullId;
+            }
+            elementIndex += size;
+            return;
+        }
+
         for(int i = 0; i < size; i++) {
-            bool valid = vector->checkValid(i);
+            bool valid = vector->checkValid(i + vectorIndex);
             if(elementIndex % pixelStride == 0) {
                 int pixelId = elementIndex / pixelStride;
                 // TODO: should write the remaining code
             }
-            if(vector->checkValid(i) && (filterMask == nullptr || filterMask->get(i))) {
+            if(vector->checkValid(i + vectorIndex) && (filterMask == nullptr || filterMask->get(i))) {
                 int originId = cascadeRLE ? (int) contentDecoder->next() : contentBuf->getInt();
                 int tmpLen = dictStarts[originId + 1] - dictStarts[originId];
                 // use setRef instead of setVal to reduce memory copy.
@@ -79,7 +96,7 @@ void StringColumnReader::read(std::shared_ptr<ByteBuffer> input, pixels::proto::
                 int pixelId = elementIndex / pixelStride;
                 // TODO: should write the remaining code
             }
-            bool valid = vector->checkValid(i);
+            bool valid = vector->checkValid(i + vectorIndex);
             if(valid && (filterMask == nullptr || filterMask->get(i))) {
                 currentStart = nextStart;
                 nextStart = startsBuf->getInt();
@@ -104,6 +121,32 @@ void StringColumnReader::read(std::shared_ptr<ByteBuffer> input, pixels::proto::
     }
 }
 
+void StringColumnReader::skip(std::shared_ptr<ByteBuffer> input, pixels::proto::ColumnEncoding & encoding, int offset,
+                              int size, int pixelStride, pixels::proto::ColumnChunkIndex & chunkIndex) {
+    if(offset == 0) {
+        elementIndex = 0;
+        bufferOffset = 0;
+        isNullOffset = chunkIndex.isnulloffset();
+        readContent(input, input->bytesRemaining(), encoding);
+    }
+
+    if (encoding.kind() == pixels::proto::ColumnEncoding_Kind_DICTIONARY) {
+        // read() consumes one dictionary id per element, whether it is null or not
+        if (encoding.has_cascadeencoding() && encoding.cascadeencoding().kind() == pixels::proto::ColumnEncoding_Kind_RUNLENGTH) {
+            skipEncoded(contentDecoder, size, pixelStride, chunkIndex);
+        } else {
+            contentBuf->skipBytes(size * sizeof(int));
+        }
+    } else {
+        // the starts array has one entry per element, so jump to the start of the next element
+        int lastStart = nextStart;
+        startsBuf->skipBytes((size - 1) * sizeof(int));
+        nextStart = startsBuf->getInt();
+        bufferOffset += nextStart - lastStart;
+    }
+    skipValid(size, pixelStride, chunkIndex);
+}
+
 void StringColumnReader::readContent(std::shared_ptr<ByteBuffer> input,
                                      uint32_t inputLength,
                                      pixels::proto::ColumnEncoding & encoding) {
@@ -146,6 +189,7 @@ void StringColumnReader::readContent(std::shared_ptr<ByteBuffer> input,
             {
                 throw new InvalidArgumentException("the dictionary size is inconsistent with the size of the starts array");
             }
+            startsLength = startsSize;
             dictStarts = new int[startsSize];
             for (int i = 0; i < startsSize; ++i)
             {
@@ -153,6 +197,7 @@ void StringColumnReader::readContent(std::shared_ptr<ByteBuffer> input,
             }
             contentDecoder = nullptr;
         }
+        dictionary = nullptr;
     } else {
         input->markReaderIndex();
         input->skipBytes(inputLength - sizeof(int));
@@ -165,6 +210,20 @@ void StringColumnReader::readContent(std::shared_ptr<ByteBuffer> input,
         nextStart = startsBuf->getInt(); // read out the first start offset, which is 0
     }
 }
+void StringColumnReader::buildDictionary() {
+    // startsLength - 1 entries of the dictionary, followed by the entry of null
+    int dictSize = startsLength - 1;
+    dictionary = std::make_shared<duckdb::Vector>(duckdb::LogicalType::VARCHAR, startsLength);
+    auto values = duckdb::FlatVector::GetData<duckdb::string_t>(*dictionary);
+    for (int i = 0; i < dictSize; i++) {
+        // the entries refer to the chunk buffer like setRef
+        values[i] = duckdb::string_t((char *) dictContentBuf->getPointer() + dictStarts[i],
+                                     dictStarts[i + 1] - dictStarts[i]);
+    }
+    values[dictSize] = duckdb::string_t((uint32_t) 0);
+    duckdb::FlatVector::SetNull(*dictionary, dictSize, true);
+}
+
 StringColumnReader::~StringColumnReader() {
 	if(dictStarts != nullptr) {
 		delete[] dictStarts;
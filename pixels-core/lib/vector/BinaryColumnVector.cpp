@@ -8,6 +8,13 @@ BinaryColumnVector::BinaryColumnVector(uint64_t len, bool encoding): ColumnVecto
     posix_memalign(reinterpret_cast<void **>(&vector), 32,
                    len * sizeof(duckdb::string_t));
     memoryUsage += (long) sizeof(uint8_t) * len;
+    dictionaryEncoded = false;
+    dictionarySize = 0;
+    dictIds = nullptr;
+    if(encoding) {
+        posix_memalign(reinterpret_cast<void **>(&dictIds), 32, len * sizeof(uint32_t));
+        memoryUsage += (long) sizeof(uint32_t) * len;
+    }
 }
 
 void BinaryColumnVector::close() {
@@ -15,6 +22,11 @@ void BinaryColumnVector::close() {
 		ColumnVector::close();
 		free(vector);
 		vector = nullptr;
+		if(dictIds != nullptr) {
+			free(dictIds);
+			dictIds = nullptr;
+		}
+		dictionary = nullptr;
 
 	}
 }
@@ -48,6 +60,14 @@ void * BinaryColumnVector::current() {
     }
 }
 
+uint32_t * BinaryColumnVector::currentDictIds() {
+    if(dictIds == nullptr) {
+        return nullptr;
+    } else {
+        return dictIds + readIndex;
+    }
+}
+
 void BinaryColumnVector::add(std::string value) {
     size_t len = value.size();
     uint8_t* buffer = new uint8_t[len];
@@ -8,12 +8,14 @@ ColumnVector::ColumnVector(uint64_t len, bool encoding) {
     writeIndex = 0;
     readIndex = 0;
     length = len;
+    capacity = len;
 	this->encoding = encoding;
     memoryUsage = len + sizeof(int) * 3 + 4;
 	closed = false;
     isNull = new uint8_t[length]();
     noNulls = true;
     posix_memalign(reinterpret_cast<void **>(&isValid), 64, ceil(1.0 * len / 64) * sizeof(uint64_t));
+    repeating.resize((len + STANDARD_VECTOR_SIZE - 1) / STANDARD_VECTOR_SIZE, false);
 }
 
 void ColumnVector::close() {
@@ -31,6 +33,7 @@ void ColumnVector::close() {
 void ColumnVector::reset() {
     writeIndex = 0;
     readIndex = 0;
+    std::fill(repeating.begin(), repeating.end(), false);
     // TODO: reset other variables
 }
 
@@ -51,8 +54,8 @@ uint64_t ColumnVector::position() {
 }
 
 void ColumnVector::resize(int size) {
-    if(this->length < size) {
-        throw InvalidArgumentException("column vector can only be resized to a smaller vector. ");
+    if(this->capacity < size) {
+        throw InvalidArgumentException("column vector can only be resized within its capacity. ");
     } else {
         this->length = size;
     }
@@ -69,6 +72,11 @@ uint64_t * ColumnVector::currentValid() {
     return isValid + readIndex / 64;
 }
 
+bool ColumnVector::isRepeating() {
+    uint64_t block = readIndex / STANDARD_VECTOR_SIZE;
+    return readIndex % STANDARD_VECTOR_SIZE == 0 && block < repeating.size() && repeating[block];
+}
+
 void ColumnVector::addNull() {
     if (writeIndex >= length) {
         ensureSize(writeIndex * 2, true);
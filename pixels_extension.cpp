@@ -12,6 +12,7 @@
 #include "duckdb/function/scalar_function.hpp"
 #include "duckdb/common/optional_ptr.hpp"
 #include <duckdb/parser/parsed_data/create_scalar_function_info.hpp>
+#include "physical/DeviceStatistics.h"
 
 namespace duckdb {
 
@@ -37,6 +38,43 @@ unique_ptr<TableRef> PixelsScanReplacement(ClientContext &context,ReplacementSca
     return std::move(table_function);
 }
 
+//! The measurements and the merge parameters of the storage devices, see DeviceStatistics
+struct PixelsDeviceStatsState : public GlobalTableFunctionState {
+	std::vector<DeviceStatistic> statistics;
+	idx_t offset = 0;
+};
+
+static unique_ptr<FunctionData> PixelsDeviceStatsBind(ClientContext &context, TableFunctionBindInput &input,
+                                                      vector<LogicalType> &return_types, vector<string> &names) {
+	names = {"device", "requests", "bytes", "latency_ms", "bandwidth_mbps", "merge_gap", "max_merge_size"};
+	return_types = {LogicalType::VARCHAR, LogicalType::UBIGINT, LogicalType::UBIGINT, LogicalType::DOUBLE,
+	                LogicalType::DOUBLE, LogicalType::INTEGER, LogicalType::INTEGER};
+	return make_uniq<TableFunctionData>();
+}
+
+static unique_ptr<GlobalTableFunctionState> PixelsDeviceStatsInit(ClientContext &context, TableFunctionInitInput &input) {
+	auto result = make_uniq<PixelsDeviceStatsState>();
+	result->statistics = ::DeviceStatistics::Instance().getStatistics();
+	return std::move(result);
+}
+
+static void PixelsDeviceStatsFunction(ClientContext &context, TableFunctionInput &data_p, DataChunk &output) {
+	auto &state = data_p.global_state->Cast<PixelsDeviceStatsState>();
+	idx_t count = 0;
+	while (state.offset < state.statistics.size() && count < STANDARD_VECTOR_SIZE) {
+		auto &statistic = state.statistics[state.offset++];
+		output.SetValue(0, count, Value(statistic.device));
+		output.SetValue(1, count, Value::UBIGINT(statistic.requests));
+		output.SetValue(2, count, Value::UBIGINT(statistic.bytes));
+		output.SetValue(3, count, Value::DOUBLE(statistic.latency * 1000));
+		output.SetValue(4, count, Value::DOUBLE(statistic.bandwidth / 1024 / 1024));
+		output.SetValue(5, count, Value::INTEGER(statistic.mergeGap));
+		output.SetValue(6, count, Value::INTEGER(statistic.maxMergeSize));
+		count++;
+	}
+	output.SetCardinality(count);
+}
+
 void PixelsExtension::Load(DuckDB &db) {
 	Connection con(*db.instance);
 	con.BeginTransaction();
@@ -49,6 +87,11 @@ void PixelsExtension::Load(DuckDB &db) {
 	cinfo.name = "pixels_scan";
 
 	catalog.CreateTableFunction(context, &cinfo);
+
+	TableFunction stats_fun("pixels_device_stats", {}, PixelsDeviceStatsFunction, PixelsDeviceStatsBind,
+	                        PixelsDeviceStatsInit);
+	CreateTableFunctionInfo stats_info(stats_fun);
+	catalog.CreateTableFunction(context, &stats_info);
 	con.Commit();
 
 	auto &config = DBConfig::GetConfig(*db.instance);
@@ -30,7 +30,16 @@
 #include <thread>
 #include <string>
 #include <random>
+#include <algorithm>
+#include <set>
+#include <climits>
 #include "PixelsBitMask.h"
+#include "reader/IntegerColumnReader.h"
+#include "vector/LongColumnVector.h"
+#include "utils/BitUtils.h"
+#include "physical/BufferPool.h"
+#include "physical/StorageArrayScheduler.h"
+#include "physical/natives/DirectUringRandomAccessFile.h"
 using namespace std;
 //
 //
@@ -626,6 +635,29 @@ TEST(reader, filterMaskTest) {
 
 }
 
+TEST(reader, filterMaskSelectionTest) {
+	PixelsBitMask filterMask(1025);
+	EXPECT_TRUE(filterMask.isAll(0, 1025));
+	EXPECT_EQ(filterMask.count(0, 1025), 1025);
+	for(int i = 0; i < 1025; i++) {
+		filterMask.set(i, i % 3 == 0);
+	}
+	EXPECT_FALSE(filterMask.isAll(0, 1025));
+	EXPECT_EQ(filterMask.count(0, 1025), 342);
+	EXPECT_EQ(filterMask.count(1, 2), 0);
+	std::vector<uint32_t> sel(1025);
+	long selSize = filterMask.toSelection(5, 1000, sel.data());
+	EXPECT_EQ(selSize, filterMask.count(5, 1000));
+	for(long i = 0; i < selSize; i++) {
+		EXPECT_EQ((sel[i] + 5) % 3, 0);
+	}
+	EXPECT_EQ(sel[0], 1);
+	for(int i = 0; i < 1025; i++) {
+		filterMask.set(i, 0);
+	}
+	EXPECT_TRUE(filterMask.isNone());
+}
+
 static const uint32_t TestRowNum = 10;
 
 template<class T> 
@@ -653,7 +685,7 @@ TEST(reader, runLengthTest) {
     }
     long* decoderValues = new long[TestRowNum];
     RunLenIntEncoder encoder(true, true);
-    byte* bytes = new byte[TestRowNum * sizeof(long) * 2];
+    ::byte* bytes = new ::byte[TestRowNum * sizeof(long) * 2];
     int len = 0;
     encoder.encode(values, bytes, TestRowNum, len);
     std::shared_ptr<ByteBuffer> buffer = std::make_shared<ByteBuffer>(bytes, len, true);
@@ -669,3 +701,343 @@ TEST(reader, runLengthTest) {
     delete[] values;
     delete[] decoderValues;
 }
+
+TEST(reader, runLengthNextRunTest) {
+    RunLenIntEncoder encoder(true, true);
+    int len = 0;
+    // a short repeat of 5 values, a non-repeating run, a fixed run of 100 values, and a tail
+    std::vector<long> runValues(5, 7);
+    for (long v = 1; v <= 4; v++) {
+        runValues.push_back(v);
+    }
+    runValues.insert(runValues.end(), 100, 9);
+    runValues.push_back(5);
+    runValues.push_back(-6);
+    std::vector<uint8_t> runBytes(runValues.size() * sizeof(long) * 2);
+    encoder.encode(runValues.data(), runBytes.data(), runValues.size(), len);
+    auto * runData = new uint8_t[len];
+    std::copy(runBytes.begin(), runBytes.begin() + len, runData);
+    RunLenIntDecoder runDecoder(std::make_shared<ByteBuffer>(runData, len, true), true);
+    int runLen;
+    bool repeating;
+    // nextRun stops at num, and then returns the rest of the same run
+    const long * run = runDecoder.nextRun(3, runLen, repeating);
+    EXPECT_EQ(runLen, 3);
+    EXPECT_TRUE(repeating);
+    EXPECT_EQ(run[0], 7);
+    run = runDecoder.nextRun(100, runLen, repeating);
+    EXPECT_EQ(runLen, 2);
+    EXPECT_TRUE(repeating);
+    EXPECT_EQ(run[0], 7);
+    std::vector<long> runDecoded(5, 7);
+    bool foundFixedRun = false;
+    while (runDecoded.size() < runValues.size()) {
+        run = runDecoder.nextRun(runValues.size(), runLen, repeating);
+        ASSERT_GT(runLen, 0);
+        if (repeating) {
+            EXPECT_TRUE(std::all_of(run, run + runLen, [&](long v) { return v == run[0]; }));
+        }
+        if (run[0] == 9) {
+            EXPECT_TRUE(repeating);
+            EXPECT_EQ(runLen, 100);
+            foundFixedRun = true;
+        }
+        runDecoded.insert(runDecoded.end(), run, run + runLen);
+    }
+    EXPECT_TRUE(foundFixedRun);
+    EXPECT_EQ(runDecoded, runValues);
+}
+
+/**
+ * Encode a nullable long column chunk laid out as IntegerColumnWriter does: the
+ * run-length encoded pixels, then the isNull bitmaps of the pixels that have nulls,
+ * with the pixel positions and statistics in chunkIndex. The nulls are padded with 0,
+ * as the readers decode one value per row.
+ */
+static std::shared_ptr<ByteBuffer> encodeLongChunk(const std::vector<long> & values, const std::vector<bool> & isNull,
+                                                   int pixelStride, pixels::proto::ColumnChunkIndex & chunkIndex) {
+    std::vector<uint8_t> content;
+    std::vector<uint8_t> bitmaps;
+    RunLenIntEncoder encoder(true, true);
+    for (int start = 0; start < values.size(); start += pixelStride) {
+        int num = std::min(pixelStride, (int) values.size() - start);
+        std::vector<long> pixel(num);
+        bool hasNull = false;
+        long min = LONG_MAX;
+        long max = LONG_MIN;
+        for (int i = 0; i < num; i++) {
+            if (isNull[start + i]) {
+                pixel[i] = 0;
+                hasNull = true;
+            } else {
+                pixel[i] = values[start + i];
+                min = std::min(min, pixel[i]);
+                max = std::max(max, pixel[i]);
+            }
+        }
+        chunkIndex.add_pixelpositions(content.size());
+        std::vector<uint8_t> bytes(num * sizeof(long) * 2);
+        int len = 0;
+        encoder.encode(pixel.data(), bytes.data(), num, len);
+        content.insert(content.end(), bytes.begin(), bytes.begin() + len);
+        auto * statistic = chunkIndex.add_pixelstatistics()->mutable_statistic();
+        statistic->set_hasnull(hasNull);
+        if (min <= max) {
+            statistic->mutable_intstatistics()->set_minimum(min);
+            statistic->mutable_intstatistics()->set_maximum(max);
+        }
+        if (hasNull) {
+            std::vector<bool> pixelIsNull(isNull.begin() + start, isNull.begin() + start + num);
+            auto bitmap = BitUtils::bitWiseCompact(pixelIsNull, num, ByteOrder::PIXELS_LITTLE_ENDIAN);
+            bitmaps.insert(bitmaps.end(), bitmap.begin(), bitmap.end());
+        }
+    }
+    chunkIndex.set_isnulloffset(content.size());
+    content.insert(content.end(), bitmaps.begin(), bitmaps.end());
+    auto * data = new uint8_t[content.size()];
+    std::copy(content.begin(), content.end(), data);
+    return std::make_shared<ByteBuffer>(data, content.size(), true);
+}
+
+/**
+ * Check the size values read into the vector against the rows from start.
+ */
+static void checkLongBatch(const std::shared_ptr<LongColumnVector> & vector, const std::vector<long> & values,
+                           const std::vector<bool> & isNull, int start, int size) {
+    for (int i = 0; i < size; i++) {
+        EXPECT_EQ(vector->checkValid(i), !isNull[start + i]) << "row " << start + i;
+        if (!isNull[start + i]) {
+            EXPECT_EQ(vector->longVector[i], values[start + i]) << "row " << start + i;
+        }
+    }
+}
+
+TEST(reader, multiPixelBatchTest) {
+    const int pixelStride = 16;
+    const int rowNum = 70;
+    std::vector<long> values(rowNum);
+    std::vector<bool> isNull(rowNum);
+    for (int i = 0; i < rowNum; i++) {
+        values[i] = i * 3 - 50;
+        // the third pixel has no null
+        isNull[i] = (i / pixelStride != 2) && (i % 5 == 1);
+    }
+    pixels::proto::ColumnChunkIndex chunkIndex;
+    auto chunk = encodeLongChunk(values, isNull, pixelStride, chunkIndex);
+    pixels::proto::ColumnEncoding encoding;
+    encoding.set_kind(pixels::proto::ColumnEncoding_Kind_RUNLENGTH);
+
+    IntegerColumnReader reader(TypeDescription::createLong());
+    auto vector = std::make_shared<LongColumnVector>(rowNum);
+    // batches of 7 rows, which span the first two pixels
+    int row = 0;
+    for (; row + 7 <= 28; row += 7) {
+        reader.read(chunk, encoding, row, 7, pixelStride, 0, vector, chunkIndex, nullptr);
+        checkLongBatch(vector, values, isNull, row, 7);
+    }
+    // skip a part of the second pixel and a part of the third one
+    reader.skip(chunk, encoding, row, 7, pixelStride, chunkIndex);
+    row += 7;
+    // a batch cut before the fourth pixel, which is then skipped as a whole
+    reader.read(chunk, encoding, row, 48 - row, pixelStride, 0, vector, chunkIndex, nullptr);
+    checkLongBatch(vector, values, isNull, row, 48 - row);
+    reader.skip(chunk, encoding, 48, pixelStride, pixelStride, chunkIndex);
+    // the last pixel is partial
+    reader.read(chunk, encoding, 64, rowNum - 64, pixelStride, 0, vector, chunkIndex, nullptr);
+    checkLongBatch(vector, values, isNull, 64, rowNum - 64);
+}
+
+TEST(reader, runLengthRepeatingTest) {
+    // each pixel is an output chunk: the first one has a single value and is filled
+    // from its statistics, the second one is decoded as repeating runs of 0 but has
+    // nulls, and the third one is increasing
+    const int pixelStride = STANDARD_VECTOR_SIZE;
+    const int rowNum = pixelStride * 3;
+    std::vector<long> values(rowNum, 42);
+    std::vector<bool> isNull(rowNum, false);
+    for (int i = pixelStride; i < pixelStride * 2; i++) {
+        values[i] = 0;
+        isNull[i] = i % 100 == 0;
+    }
+    for (int i = pixelStride * 2; i < rowNum; i++) {
+        values[i] = i;
+    }
+    pixels::proto::ColumnChunkIndex chunkIndex;
+    auto chunk = encodeLongChunk(values, isNull, pixelStride, chunkIndex);
+    // overwrite the encoded first pixel, so that it only reads right from the statistics
+    std::fill(chunk->getPointer(), chunk->getPointer() + chunkIndex.pixelpositions(1), 0);
+    pixels::proto::ColumnEncoding encoding;
+    encoding.set_kind(pixels::proto::ColumnEncoding_Kind_RUNLENGTH);
+
+    IntegerColumnReader reader(TypeDescription::createLong());
+    auto vector = std::make_shared<LongColumnVector>(rowNum);
+    reader.read(chunk, encoding, 0, rowNum, pixelStride, 0, vector, chunkIndex, nullptr);
+    checkLongBatch(vector, values, isNull, 0, rowNum);
+    EXPECT_TRUE(vector->repeating[0]);
+    EXPECT_FALSE(vector->repeating[1]);
+    EXPECT_FALSE(vector->repeating[2]);
+}
+
+TEST(reader, skipPixelTest) {
+    // three pixels with nulls, the middle one is skipped as a pruned pixel is
+    const int pixelStride = 16;
+    const int rowNum = pixelStride * 3;
+    std::vector<long> values(rowNum);
+    std::vector<bool> isNull(rowNum);
+    for (int i = 0; i < rowNum; i++) {
+        values[i] = 100 - i * 3;
+        // each pixel has its own null pattern
+        isNull[i] = i % pixelStride % (i / pixelStride + 2) == 0;
+    }
+    pixels::proto::ColumnEncoding encoding;
+    encoding.set_kind(pixels::proto::ColumnEncoding_Kind_RUNLENGTH);
+
+    for (bool hasPositions : {true, false}) {
+        pixels::proto::ColumnChunkIndex chunkIndex;
+        auto chunk = encodeLongChunk(values, isNull, pixelStride, chunkIndex);
+        if (!hasPositions) {
+            // the skipped pixel is then decoded and dropped instead of sought over
+            chunkIndex.clear_pixelpositions();
+        }
+        IntegerColumnReader reader(TypeDescription::createLong());
+        auto vector = std::make_shared<LongColumnVector>(pixelStride);
+        reader.read(chunk, encoding, 0, pixelStride, pixelStride, 0, vector, chunkIndex, nullptr);
+        checkLongBatch(vector, values, isNull, 0, pixelStride);
+        reader.skip(chunk, encoding, pixelStride, pixelStride, pixelStride, chunkIndex);
+        reader.read(chunk, encoding, pixelStride * 2, pixelStride, pixelStride, 0, vector, chunkIndex, nullptr);
+        checkLongBatch(vector, values, isNull, pixelStride * 2, pixelStride);
+    }
+}
+
+TEST(reader, uringRegisteredFileTest) {
+    // the files are registered to the ring by default, so the reads go through the fixed file table
+    ASSERT_TRUE(ConfigFactory::Instance().boolCheckProperty("localfs.iouring.register.files"));
+    char path[] = "/tmp/pixels_uring_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    std::vector<uint8_t> content(4 * 4096);
+    for (int i = 0; i < content.size(); i++) {
+        content[i] = i % 251;
+    }
+    ASSERT_EQ(write(fd, content.data(), content.size()), (ssize_t) content.size());
+    close(fd);
+
+    // an unaligned chunk of each of two columns
+    std::vector<uint32_t> colIds = {0, 1};
+    std::vector<uint64_t> offsets = {100, 5000};
+    std::vector<uint64_t> lengths = {4000, 7000};
+    BufferPool::Initialize(colIds, lengths, {"a", "b"});
+    DirectUringRandomAccessFile::Initialize();
+    DirectUringRandomAccessFile::RegisterBufferFromPool(colIds);
+    DirectUringRandomAccessFile file(path);
+    std::vector<std::shared_ptr<ByteBuffer>> results;
+    for (int i = 0; i < colIds.size(); i++) {
+        file.seek(offsets[i]);
+        results.emplace_back(file.readAsync(lengths[i], BufferPool::GetBuffer(colIds[i]), BufferPool::GetBufferId(i)));
+    }
+    file.readAsyncSubmit(colIds.size());
+    file.readAsyncComplete(colIds.size(), BufferPool::GetBufferSlot());
+    for (int i = 0; i < colIds.size(); i++) {
+        EXPECT_TRUE(std::equal(results[i]->getPointer(), results[i]->getPointer() + lengths[i],
+                               content.begin() + offsets[i])) << "column " << i;
+    }
+    file.close();
+    DirectUringRandomAccessFile::Reset();
+    BufferPool::Reset();
+    remove(path);
+}
+
+TEST(reader, storageArraySchedulerTest) {
+    // the files are striped over two devices, with storage.directory.depth=1
+    std::vector<std::string> files = {"/ssd1/a.pxl", "/ssd2/b.pxl", "/ssd1/c.pxl"};
+    std::vector<int> rowGroupNums = {10, 10, 10};
+    {
+        // a single thread takes all the tasks in order, though it was planned for more threads
+        StorageArrayScheduler scheduler(files, rowGroupNums, 4);
+        int deviceID = scheduler.acquireDeviceId();
+        int64_t lastBatchID = -1;
+        StorageScanTask task;
+        while (scheduler.acquireTask(deviceID, lastBatchID, task)) {
+            EXPECT_EQ(task.batchID, lastBatchID + 1);
+            lastBatchID = task.batchID;
+        }
+        EXPECT_EQ(lastBatchID, 29);
+        EXPECT_EQ(scheduler.getAcquiredTaskSum(), scheduler.getTaskSum());
+    }
+    {
+        // while the thread of the first device is stalled, the other thread takes its own
+        // tasks and steals the ones after them, and the stalled thread then takes the rest
+        StorageArrayScheduler scheduler(files, rowGroupNums, 2);
+        int stalledDeviceID = scheduler.acquireDeviceId();
+        int deviceID = scheduler.acquireDeviceId();
+        std::vector<int64_t> batchIDs;
+        StorageScanTask task;
+        int64_t lastBatchID = -1;
+        while (scheduler.acquireTask(deviceID, lastBatchID, task)) {
+            EXPECT_GT(task.batchID, lastBatchID);
+            lastBatchID = task.batchID;
+            batchIDs.emplace_back(task.batchID);
+        }
+        EXPECT_EQ(batchIDs.size(), 20);
+        EXPECT_EQ(batchIDs.front(), 10);
+        lastBatchID = -1;
+        while (scheduler.acquireTask(stalledDeviceID, lastBatchID, task)) {
+            EXPECT_GT(task.batchID, lastBatchID);
+            lastBatchID = task.batchID;
+            batchIDs.emplace_back(task.batchID);
+        }
+        EXPECT_EQ(batchIDs.size(), 30);
+        EXPECT_EQ(scheduler.getAcquiredTaskSum(), scheduler.getTaskSum());
+    }
+    {
+        // threads taking turns at random never lose a task, and each sees increasing batch IDs
+        std::default_random_engine e(7);
+        for (int round = 0; round < 100; round++) {
+            StorageArrayScheduler scheduler(files, rowGroupNums, 3);
+            std::vector<int> deviceIDs;
+            std::vector<int64_t> lastBatchIDs;
+            std::vector<int> running;
+            for (int i = 0; i < 3; i++) {
+                deviceIDs.emplace_back(scheduler.acquireDeviceId());
+                lastBatchIDs.emplace_back(-1);
+                running.emplace_back(i);
+            }
+            std::set<int64_t> batchIDs;
+            while (!running.empty()) {
+                int pick = std::uniform_int_distribution<int>(0, (int) running.size() - 1)(e);
+                int thread = running.at(pick);
+                StorageScanTask task;
+                if (!scheduler.acquireTask(deviceIDs.at(thread), lastBatchIDs.at(thread), task)) {
+                    running.erase(running.begin() + pick);
+                    continue;
+                }
+                EXPECT_GT(task.batchID, lastBatchIDs.at(thread));
+                lastBatchIDs.at(thread) = task.batchID;
+                batchIDs.insert(task.batchID);
+            }
+            EXPECT_EQ(batchIDs.size(), 30);
+            EXPECT_EQ(scheduler.getAcquiredTaskSum(), scheduler.getTaskSum());
+        }
+    }
+}
+
+TEST(reader, bufferPoolGrowthTest) {
+    // an unaligned direct read of len bytes takes up to len + 2 * block - 2 bytes of its buffer
+    uint64_t block = std::stoi(ConfigFactory::Instance().getProperty("localfs.block.size"));
+    auto directReadBytes = [block](uint64_t len) { return (len + 2 * block - 2) / block * block; };
+    BufferPool::Reset();
+    // the size classes of the BufferManager start from 64 KB, so the buffers are larger than that
+    uint64_t bytes = 64 * 1024;
+    BufferPool::Initialize({0}, {bytes}, {"a"});
+    for (uint64_t len : {bytes + block / 2, bytes * 3 / 2 + block, bytes * 4 + 1}) {
+        BufferPool::Initialize({0}, {len}, {"a"});
+        EXPECT_GE(BufferPool::GetBuffer(0)->size(), directReadBytes(len));
+    }
+    // the merged reads reserve the buffer of the first chunk, which grows the same way
+    int64_t bufferId = BufferPool::GetBufferId(0);
+    for (int i = 0; i < 2; i++) {
+        uint64_t len = BufferPool::GetBuffer(0)->size() - block / 2;
+        EXPECT_GE(BufferPool::Reserve(bufferId, len)->size(), directReadBytes(len));
+    }
+    BufferPool::Reset();
+}